@@ -0,0 +1,128 @@
+#pragma once
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains arena allocation for polynomials
+///	@details	Polynomials using \c ArenaAllocator take their memory from the arena of the calling thread that is current
+///				when they are constructed (set via \c ArenaScope) and otherwise from the global heap. \c PolynomialBasis opens
+///				an arena for every decomposition and resets it after each step of the reduction, so the temporary products
+///				never touch the global heap.
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief		Monotonic (bump pointer) memory resource that keeps its memory when reset
+	///	@details	Deallocation does nothing; memory is reclaimed all at once by \ref reset . When several blocks
+	///				were needed, \ref reset replaces them by a single block of the combined size, so after a few resets
+	///				a repeated computation is served by one block without any call to the upstream allocator.
+	///	@warning	Not thread safe: use one arena per thread.
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class MonotonicArena : public std::pmr::memory_resource
+	{
+	public:
+		///	@brief				Constructor; no memory is allocated until it is requested
+		///	@param	block_size	The size in bytes of the first block
+		MonotonicArena(size_t block_size = 1 << 16);
+
+		///	@brief	Returns all blocks to the upstream allocator
+		~MonotonicArena();
+
+		MonotonicArena(const MonotonicArena &) = delete;
+		MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+		///	@brief		Reclaims all memory handed out by the arena, keeping it for future allocations
+		///	@warning	Every object allocated from the arena must have been destroyed
+		void reset();
+
+		///	@brief	The number of bytes handed out since the last reset
+		size_t bytes_used() const;
+
+		///	@brief	The number of bytes held by the arena
+		size_t capacity() const;
+
+	private:
+		std::vector<std::pair<char *, size_t>> blocks;
+		size_t block_size, current, offset, used;
+		void *do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void *, size_t, size_t) override;
+		bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+		void release();
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief		Sets the arena of the calling thread for its lifetime
+	///	@details	Every container using \c ArenaAllocator that is constructed while the scope is alive allocates from the arena.
+	///				Scopes can be nested; the previous arena is restored on destruction.
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class ArenaScope
+	{
+	public:
+		///	@brief			Makes \p arena the arena of the calling thread
+		///	@param	arena	The memory resource to use, eg a \c MonotonicArena
+		ArenaScope(std::pmr::memory_resource *arena);
+
+		///	@brief	Restores the previous arena
+		~ArenaScope();
+
+		ArenaScope(const ArenaScope &) = delete;
+		ArenaScope &operator=(const ArenaScope &) = delete;
+
+		///	@brief	The arena of the calling thread (the global heap if no \c ArenaScope is alive)
+		static std::pmr::memory_resource *current();
+
+	private:
+		std::pmr::memory_resource *previous;
+		static std::pmr::memory_resource *&current_arena();
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief		Polymorphic allocator that binds to the arena of the calling thread when constructed
+	///	@details	Copies of a container are also bound to the arena that is current when they are made,
+	///				while moves and assignments keep the memory resource of the target.
+	///	@tparam	T	The value type
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class T>
+	struct ArenaAllocator : public std::pmr::polymorphic_allocator<T>
+	{
+		///	@brief	Allocator using \ref ArenaScope::current
+		ArenaAllocator();
+
+		///	@brief	Allocator using given memory resource
+		ArenaAllocator(std::pmr::memory_resource *resource);
+
+		///	@brief	Rebinding constructor
+		template <class U>
+		ArenaAllocator(const ArenaAllocator<U> &other);
+
+		///	@brief	Copied containers use the arena that is current at the time of the copy
+		ArenaAllocator select_on_container_copy_construction() const;
+	};
+}
+
+//the arena itself does not depend on the polynomials, which use ArenaScope in their implementation
+#include "Polynomials.hpp"
+
+namespace symmp
+{
+	/// @brief			Polynomial using \c std::map or \c MonomialMap with memory taken from the current arena
+	/// @tparam _scl	The scalar/coefficient type of the polynomial
+	/// @tparam _exp	The variable/exponent type of the Polynomial eg \c PackedStandardVariables or \c PackedHalfIdempotentVariables
+	/// @tparam _ord	If ```_ord==1``` then \c std::map is used as the container for the polynomial; otherwise \c MonomialMap is used
+	///	@note			Exponents that allocate by themselves (eg \c StandardVariables) still use the global heap; packed exponents do not.
+	template <class _scl, class _exp, bool _ord = 1>
+	using ArenaPoly = Polynomial<std::conditional_t<_ord,
+		DefaultContainer<_scl, _exp, std::map, 1, std::less<implementation_details::pair_t<_exp>>, ArenaAllocator<std::pair<const implementation_details::pair_t<_exp>, _scl>>>,
+		DefaultContainer<_scl, _exp, MonomialMap, 0, std::equal_to<implementation_details::pair_t<_exp>>, ArenaAllocator<std::pair<const implementation_details::pair_t<_exp>, _scl>>>>>;
+
+	/// @brief			Polynomial using \c FlatContainer with memory taken from the current arena
+	/// @tparam _scl	The scalar/coefficient type of the polynomial
+	/// @tparam _exp	The variable/exponent type of the Polynomial eg \c PackedStandardVariables or \c PackedHalfIdempotentVariables
+	template <class _scl, class _exp>
+	using ArenaFlatPoly = Polynomial<FlatContainer<_scl, _exp, ArenaAllocator<std::pair<implementation_details::pair_t<_exp>, _scl>>>>;
+}
+#include "impl/Arena.ipp"
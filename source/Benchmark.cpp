@@ -0,0 +1,215 @@
+#include "Half_Idempotent.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+
+///	@file
+///	@brief		A benchmark of the core kernels that can be compiled, printing its results as JSON
+///	@details	Times multiplication, addition, powers and \c highest_term of polynomials, the construction of \c SymmetricBasis and
+///				\c TwistedChernBasis , single decompositions and \c print_half_idempotent_relations (without printing) for a range of \f$n\f$.
+///				Every kernel runs on the ordered container (```Poly<...,1>```, \c std::map ) and on the unordered one (```Poly<...,0>```, \c MonomialMap )
+///				with the exponents hashed by \c boost_hash (the default) and by \c crc .
+///
+///				Usage: ```Benchmark [max_n] [min_seconds]``` (defaults 6 and 0.2) for \f$3\le n\le\f$ \c max_n ; every kernel is repeated for at least \c min_seconds .
+///				The JSON is written to \c stdout in the layout of Google Benchmark (so its \c compare.py can compare two runs) and the progress to \c stderr ,
+///				eg compile with ```g++ -std=c++17 -O3 -march=native Benchmark.cpp -o Benchmark``` and run ```./Benchmark 7 > results.json```
+
+using namespace symmp;
+
+///	@brief			Exponent type that is hashed with another algorithm than \c generic_hasher 's default
+///	@tparam	exp_t	The exponent type eg \c StandardVariables
+///	@tparam	hasher	The hashing algorithm eg \c crc
+template <class exp_t, class hasher>
+struct HashedWith : public exp_t
+{
+	using exp_t::exp_t;
+
+	///	@brief	Conversion from the exponent type
+	HashedWith(const exp_t &exponent) : exp_t(exponent) {}
+
+	///	@brief	Multiplies monomials by adding their exponents
+	HashedWith operator+(const HashedWith &b) const
+	{
+		return HashedWith(exp_t::operator+(b));
+	}
+
+	///	@brief	Multiplies monomials in place by adding their exponents
+	HashedWith &operator+=(const HashedWith &b)
+	{
+		exp_t::operator+=(b);
+		return *this;
+	}
+
+	///	@brief	Hashes monomial with \p hasher
+	size_t operator()() const
+	{
+		return generic_hasher<exp_t, hasher>(*this);
+	}
+};
+
+///	@brief			The polynomial types of one configuration of container and hash
+///	@tparam	ordered	Whether the container is ordered (```Poly<...,1>```)
+///	@tparam	hasher	The hashing algorithm of the exponents
+template <bool ordered, class hasher>
+struct Configuration
+{
+	///	@brief	Polynomial on given exponent type
+	template <class exp_t>
+	using poly_t = Poly<int64_t, std::conditional_t<std::is_same_v<hasher, boost_hash>, exp_t, HashedWith<exp_t, hasher>>, ordered>;
+
+	typedef poly_t<StandardVariables<uint8_t, int>> x_poly_t;				 ///<Polynomial on the \f$x_i\f$
+	typedef poly_t<ElementarySymmetricVariables<uint8_t, int>> e_poly_t;	 ///<Polynomial on the \f$e_i\f$
+	typedef poly_t<HalfIdempotentVariables<uint8_t, uint16_t>> xy_poly_t;	 ///<Polynomial on the \f$x_i,y_i\f$
+	typedef poly_t<TwistedChernVariables<uint8_t, uint16_t>> chern_poly_t; ///<Polynomial on the twisted Chern classes
+
+	///	@brief	The name of the configuration, used in the names of the benchmarks
+	static std::string name()
+	{
+		if (ordered)
+			return "ordered";
+		return std::is_same_v<hasher, boost_hash> ? "unordered,boost_hash" : "unordered,crc";
+	}
+};
+
+///	@brief	The result of a benchmark
+struct Measurement
+{
+	std::string name;	///<The name of the benchmark
+	size_t iterations;	///<How many times the kernel ran
+	double real_time;	///<Wall time per iteration in nanoseconds
+	double cpu_time;	///<Processor time per iteration (of all threads) in nanoseconds
+	size_t size;		///<The number of monomials of the result, printed so that different versions are known to compute the same thing
+};
+
+///	@brief	The results of all benchmarks and their settings
+struct Benchmarks
+{
+	double min_seconds;				  ///<The minimum time every kernel is repeated for
+	std::vector<Measurement> results; ///<The results so far
+	volatile size_t sink = 0;		  ///<Where the results of the kernels go, so that they are computed
+
+	///	@brief			Times a kernel
+	///	@param	name	The name of the benchmark
+	///	@param	kernel	Called with no arguments, returning the number of monomials of its result (which also keeps it from being optimized away)
+	template <class fun>
+	void run(const std::string &name, const fun &kernel)
+	{
+		const size_t size = kernel(); //warm up
+		size_t iterations = 1;
+		while (true)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			const auto cpu_start = std::clock();
+			for (size_t i = 0; i < iterations; i++)
+				sink = sink + kernel();
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			const double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+			if (seconds >= min_seconds || iterations >= (size_t(1) << 30))
+			{
+				results.push_back({name, iterations, seconds * 1e9 / iterations, cpu_seconds * 1e9 / iterations, size});
+				std::cerr << std::left << std::setw(64) << name << std::right << std::setw(16) << std::fixed << std::setprecision(0) << results.back().real_time << " ns\n";
+				return;
+			}
+			//aim for 1.5 times the minimum time, growing at most tenfold per round
+			iterations = std::max(iterations + 1, std::min(10 * iterations, static_cast<size_t>(1.5 * min_seconds / std::max(seconds, 1e-9) * iterations)));
+		}
+	}
+
+	///	@brief	Writes the results as JSON in the layout of Google Benchmark
+	void write_json(std::ostream &os) const
+	{
+		const auto now = std::time(nullptr);
+		char date[32];
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+		os << "{\n  \"context\": {\n";
+		os << "    \"date\": \"" << date << "\",\n";
+		os << "    \"executable\": \"Benchmark\",\n";
+		os << "    \"min_seconds\": " << min_seconds << ",\n";
+#if defined(SYMMP_CACHE_HASH)
+		os << "    \"cache_hash\": true,\n";
+#else
+		os << "    \"cache_hash\": false,\n";
+#endif
+#if defined(SYMMP_CRC32_X86) || defined(SYMMP_CRC32_ARM)
+		os << "    \"hardware_crc\": true\n";
+#else
+		os << "    \"hardware_crc\": false\n";
+#endif
+		os << "  },\n  \"benchmarks\": [\n";
+		os << std::setprecision(1) << std::fixed;
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const auto &r = results[i];
+			os << "    {\"name\": \"" << r.name << "\", \"run_name\": \"" << r.name << "\", \"run_type\": \"iteration\", \"iterations\": " << r.iterations
+			   << ", \"real_time\": " << r.real_time << ", \"cpu_time\": " << r.cpu_time << ", \"time_unit\": \"ns\", \"monomials\": " << r.size << "}"
+			   << (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		os << "  ]\n}\n";
+	}
+};
+
+///	@brief				Times the kernels on the polynomial types of a configuration for given \f$n\f$
+///	@tparam	config		The configuration eg ```Configuration<0,crc>```
+///	@param	benchmarks	Where the results are appended
+///	@param	n			The number of variables of \c SymmetricBasis , and half the number of variables of \c TwistedChernBasis
+template <class config>
+void run_kernels(Benchmarks &benchmarks, int n)
+{
+	typedef typename config::x_poly_t x_poly_t;
+	typedef typename config::e_poly_t e_poly_t;
+	typedef typename config::xy_poly_t xy_poly_t;
+	typedef typename config::chern_poly_t chern_poly_t;
+	const std::string suffix = "<" + config::name() + ">/" + std::to_string(n);
+
+	//the sum of the elementary symmetric polynomials, which has 2^n-1 monomials
+	const SymmetricBasis<x_poly_t, e_poly_t> symmetric(n);
+	x_poly_t a = symmetric.generators()[0];
+	for (int i = 1; i < n; i++)
+		a += symmetric.generators()[i];
+	const x_poly_t b = a * symmetric.generators()[n / 2];
+	benchmarks.run("multiply" + suffix, [&]() { return (a * b).number_of_monomials(); });
+	x_poly_t sum = b;
+	benchmarks.run("add_assign" + suffix, [&]() {
+		sum += a;
+		sum -= a;
+		return sum.number_of_monomials();
+	});
+	benchmarks.run("power" + suffix, [&]() { return (a ^ 3).number_of_monomials(); });
+	const x_poly_t *volatile opaque = &b; //read on every iteration, so the search isn't hoisted out of the loop
+	benchmarks.run("highest_term" + suffix, [&]() { return static_cast<size_t>(opaque->highest_term().degree()); });
+	benchmarks.run("symmetric_basis" + suffix, [&]() { return SymmetricBasis<x_poly_t, e_poly_t>(n).generators().back().number_of_monomials(); });
+	benchmarks.run("symmetric_decompose" + suffix, [&]() { return symmetric(b).number_of_monomials(); });
+
+	const TwistedChernBasis<xy_poly_t, chern_poly_t> twisted(n);
+	benchmarks.run("twisted_chern_basis" + suffix, [&]() { return TwistedChernBasis<xy_poly_t, chern_poly_t>(n).generators().back().number_of_monomials(); });
+	//the largest relation
+	const auto relations = twisted.expand_batch(twisted.relations());
+	const auto largest = std::max_element(relations.begin(), relations.end(), [](const auto &x, const auto &y) { return x.number_of_monomials() < y.number_of_monomials(); });
+	benchmarks.run("twisted_chern_decompose" + suffix, [&]() { return twisted(*largest).number_of_monomials(); });
+	benchmarks.run("print_half_idempotent_relations" + suffix, [&]() {
+		print_half_idempotent_relations<xy_poly_t, chern_poly_t>(n, 0, 0, 0);
+		return relations.size();
+	});
+}
+
+///	@brief	Runs the benchmarks for \f$3\le n\le\f$ the first argument and for at least the second argument seconds each
+int main(int argc, char **argv)
+{
+	const int max_n = argc > 1 ? std::atoi(argv[1]) : 6;
+	Benchmarks benchmarks;
+	benchmarks.min_seconds = argc > 2 ? std::atof(argv[2]) : 0.2;
+	if (max_n < 3 || max_n > 10 || benchmarks.min_seconds <= 0)
+	{
+		std::cerr << "Usage: Benchmark [max_n] [min_seconds] with 3<=max_n<=10 and min_seconds>0\n";
+		return 1;
+	}
+	for (int n = 3; n <= max_n; n++)
+	{
+		run_kernels<Configuration<1, boost_hash>>(benchmarks, n);
+		run_kernels<Configuration<0, boost_hash>>(benchmarks, n);
+		run_kernels<Configuration<0, crc>>(benchmarks, n);
+	}
+	benchmarks.write_json(std::cout);
+	return 0;
+}
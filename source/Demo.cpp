@@ -16,25 +16,29 @@ template <class xy_poly_t, class chern_poly_t>
 void pontryagin_via_chern(int n)
 {
 	TwistedChernBasis<xy_poly_t, chern_poly_t> hib(n);
-	SYMMP_RUN_LOOP_IN_PARALLEL
-		for (int s = 1; s <= n; s++)
-			for (int i = 1; i <= n - s; i++)
-			{
-				const auto& twistedChern = hib.generator(s, i);
-				xy_poly_t twistedPontryagin;
-				for (auto it = twistedChern.begin(); it != twistedChern.end(); ++it)
-					twistedPontryagin.insert(it.exponent() + it.exponent(), it.coeff());
-				std::stringstream ss;
-				ss << "k_{" << s << "," << i << "}= " << hib(twistedPontryagin) << "\n";
-				std::cout << ss.str();
-			}
+	std::vector<std::array<int, 2>> indices;
+	std::vector<xy_poly_t> twistedPontryagin;
+	for (int s = 1; s <= n; s++)
+		for (int i = 1; i <= n - s; i++)
+		{
+			const auto& twistedChern = hib.generator(s, i);
+			xy_poly_t pontryagin;
+			for (auto it = twistedChern.begin(); it != twistedChern.end(); ++it)
+				pontryagin.insert(it.exponent() + it.exponent(), it.coeff());
+			indices.push_back({s, i});
+			twistedPontryagin.push_back(std::move(pontryagin));
+		}
+	const auto decomposed = hib.decompose_batch(twistedPontryagin);
+	PolynomialWriter out(std::cout);
+	for (size_t k = 0; k < indices.size(); k++)
+		out << "k_{" << indices[k][0] << "," << indices[k][1] << "}= " << decomposed[k] << "\n";
 }
 
 /// @brief User facing interface for computing relations/writing Pontryagin/symplectic in terms of Chern.
 void show_and_tell()
 {
-	typedef Poly<int64_t, HalfIdempotentVariables<uint64_t, uint64_t>, 0> xy_poly_t;
-	typedef Poly<int64_t, TwistedChernVariables<uint64_t, uint64_t>, 0> chern_poly_t;
+	typedef GradedPoly<int64_t, HalfIdempotentVariables<uint64_t, uint64_t>> xy_poly_t;
+	typedef GradedPoly<int64_t, TwistedChernVariables<uint64_t, uint64_t>> chern_poly_t;
 
 	std::cout << "Consider the polynomial ring (over Z) with variables x_1,...,x_n,y_1,...,y_n and relations y_i^2=y_i \n";
 	std::cout << "The symmetric group Sigma_n acts on this ring by separately permuting the x_i,y_i separately\n";
@@ -112,8 +116,8 @@ void speed_test()
 {
 	//can you get less than 24 seconds?
 	constexpr int varcount = 9;
-	typedef Poly<int64_t, HalfIdempotentVariables<uint8_t, uint16_t, 2*varcount>, 0> xy_poly_t;
-	typedef Poly<int64_t, TwistedChernVariables<uint8_t, uint16_t>, 0> chern_poly_t;
+	typedef GradedPoly<int64_t, HalfIdempotentVariables<uint8_t, uint16_t, 2*varcount>> xy_poly_t;
+	typedef GradedPoly<int64_t, TwistedChernVariables<uint8_t, uint16_t>> chern_poly_t;
 	auto start = std::chrono::high_resolution_clock::now();
 	print_half_idempotent_relations<xy_poly_t, chern_poly_t>(varcount, 0, 0, 0);
 	auto end = std::chrono::high_resolution_clock::now();
@@ -0,0 +1,522 @@
+#define SYMMP_USE_OPEN_MP ///<Define this macro to enable openMP in the library (you will also need to enable openMP in your compiler).
+#include "Half_Idempotent.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+///	@file
+///	@brief		A non-interactive driver for the computations of the demo, that can be compiled
+///	@details	Computes the relations of the twisted Chern classes and/or writes the twisted Pontryagin classes in terms of them
+///				(see \c show_and_tell in Demo.cpp) for several \f$n\f$, without reading anything from the console. Usage:
+///				\code Driver [--mode relations|pontryagin|both] [--n N|N1-N2|N1,N2,...] [--threads T] [--jobs J]
+///				       [--format text|binary|none] [--output PREFIX] [--verify|--fast-verify] [--shard I/K|--merge K] [--balance] [--memory-limit MIB] \endcode
+///				- \c --mode : what to compute (default \c relations )
+///				- \c --n : the values of \f$n\f$ (default 4)
+///				- \c --threads : the total number of threads, shared by the jobs (default 0: the openMP default for every job)
+///				- \c --jobs : how many \f$n\f$ (and modes) are computed at once (default 1); the jobs share the bases of the same \f$n\f$
+///				- \c --format : \c text is the output of the demo, \c binary is the format of \c save_polynomials , \c none only times the computation
+///				- \c --output : the results of mode \c m and \f$n\f$ go to file \c PREFIXm_n.txt (or \c .bin ); otherwise text is written to \c stdout , by increasing \f$n\f$
+///				- \c --verify : expands the results back and compares
+///				- \c --fast-verify : compares both sides at random points (see \c TwistedChernBasis::probable_mismatches ) and only expands those that differ
+///				- \c --shard : computes only shard \c I of \c K of the relations (see \c TwistedChernBasis::relation_shard ), written to \c PREFIXrelations_n.I-of-K.bin (or \c .txt );
+///				  the shards are deterministic, so \c K processes (eg a job array) can compute them without any coordination
+///				- \c --merge : reads the binary files of the \c K shards and writes the results of the unsharded computation (in the order of \c --format )
+///				- \c --balance : balances the shards by cost instead of taking every \c K -th relation (the same must be given to \c --merge )
+///				- \c --memory-limit : the decompositions whose input would take more than this many MiB to split are streamed degree by degree (see \c PolynomialBasis::set_memory_limit )
+///
+///				The wall time, the percentiles of the time taken by the individual decompositions and the peak memory are written to \c stderr ,
+///				and with \c --memory-limit the largest estimated footprint of a decomposition for every \f$n\f$ .
+///				If compiled with \c SYMMP_INSTRUMENT (see Instrumentation.hpp) the instrumentation report of all jobs is written to \c stderr too.
+///				The exit code is 0 on success, 1 if a verification or an output failed and 2 on invalid arguments.
+///				Eg compile with ```g++ -std=c++17 -O3 -fopenmp Driver.cpp -o Driver``` and run ```./Driver --mode both --n 2-8 --jobs 2 --verify > out.txt```,
+///				or run ```./Driver --n 10 --format binary --output out/ --shard I/64 --balance``` for every \c I and then ```./Driver --n 10 --format binary --output out/ --merge 64 --balance``` .
+
+using namespace symmp;
+
+typedef GradedPoly<int64_t, HalfIdempotentVariables<uint8_t, uint16_t>> xy_poly_t;	 ///<Polynomial on the \f$x_i,y_i\f$
+typedef GradedPoly<int64_t, TwistedChernVariables<uint8_t, uint16_t>> chern_poly_t; ///<Polynomial on the twisted Chern classes
+typedef TwistedChernBasis<xy_poly_t, chern_poly_t> basis_t;							 ///<The basis of the twisted Chern classes
+
+///	@brief	The command line options
+struct Options
+{
+	bool relations = 1;		  ///<Whether to compute the relations
+	bool pontryagin = 0;	  ///<Whether to compute the twisted Pontryagin classes
+	std::vector<int> ns{4};	  ///<The values of \f$n\f$
+	int threads = 0;		  ///<The total number of threads; 0 uses the openMP default
+	int jobs = 1;			  ///<The number of jobs computed at once
+	std::string format = "text"; ///<One of \c text , \c binary or \c none
+	std::string output;		  ///<The prefix of the output files; empty for \c stdout
+	bool verify = 0;		  ///<Whether to verify the results
+	bool fast_verify = 0;	  ///<Whether to verify probabilistically first
+	size_t shard = 0;		  ///<The shard of the relations computed
+	size_t shards = 1;		  ///<The number of shards
+	size_t merge = 0;		  ///<The number of shards to merge; 0 computes instead
+	bool balanced = 0;		  ///<Whether the shards are balanced by cost
+	size_t memory_limit = 0;  ///<The memory limit of a decomposition in bytes; 0 for none
+};
+
+///	@brief	Parses a list of \f$n\f$ like ```5```, ```2-7``` or ```2,4,6```
+///	@return	Whether the list is valid
+bool parse_ns(const std::string &text, std::vector<int> &ns)
+{
+	ns.clear();
+	size_t start = 0;
+	while (start <= text.size())
+	{
+		const size_t end = std::min(text.find(',', start), text.size());
+		const std::string item = text.substr(start, end - start);
+		const size_t dash = item.find('-');
+		const int first = std::atoi(item.substr(0, dash).c_str());
+		const int last = dash == std::string::npos ? first : std::atoi(item.substr(dash + 1).c_str());
+		if (first < 2 || last < first)
+			return 0;
+		for (int n = first; n <= last; n++)
+			ns.push_back(n);
+		start = end + 1;
+	}
+	std::sort(ns.begin(), ns.end());
+	ns.erase(std::unique(ns.begin(), ns.end()), ns.end());
+	return !ns.empty();
+}
+
+///	@brief	Parses the command line
+///	@return	Whether the command line is valid
+bool parse(int argc, char **argv, Options &options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string flag = argv[i];
+		if (flag == "--verify" || flag == "--fast-verify")
+		{
+			options.verify = 1;
+			options.fast_verify = flag == "--fast-verify";
+			continue;
+		}
+		if (flag == "--balance")
+		{
+			options.balanced = 1;
+			continue;
+		}
+		if (i + 1 == argc)
+			return 0;
+		const std::string value = argv[++i];
+		if (flag == "--mode" && (value == "relations" || value == "pontryagin" || value == "both"))
+		{
+			options.relations = value != "pontryagin";
+			options.pontryagin = value != "relations";
+		}
+		else if (flag == "--n")
+		{
+			if (!parse_ns(value, options.ns))
+				return 0;
+		}
+		else if (flag == "--threads")
+			options.threads = std::atoi(value.c_str());
+		else if (flag == "--jobs")
+			options.jobs = std::atoi(value.c_str());
+		else if (flag == "--format" && (value == "text" || value == "binary" || value == "none"))
+			options.format = value;
+		else if (flag == "--output")
+			options.output = value;
+		else if (flag == "--shard" && value.find('/') != std::string::npos)
+		{
+			const int shard = std::atoi(value.substr(0, value.find('/')).c_str());
+			const int shards = std::atoi(value.substr(value.find('/') + 1).c_str());
+			if (shard < 0 || shards < 1 || shard >= shards)
+				return 0;
+			options.shard = shard;
+			options.shards = shards;
+		}
+		else if (flag == "--merge" && std::atoi(value.c_str()) >= 1)
+			options.merge = std::atoi(value.c_str());
+		else if (flag == "--memory-limit" && std::atof(value.c_str()) > 0)
+			options.memory_limit = static_cast<size_t>(std::atof(value.c_str()) * 1048576);
+		else
+			return 0;
+	}
+	//only the relations are sharded, and the shards are merged from binary files
+	const bool sharded = options.shards > 1 || options.merge != 0;
+	if (sharded && (options.pontryagin || (options.shards > 1 && options.merge != 0)))
+		return 0;
+	if (options.merge != 0 && options.output.empty())
+		return 0;
+	return options.threads >= 0 && options.jobs >= 1 && (options.format != "binary" || !options.output.empty());
+}
+
+///	@brief	The bases of every \f$n\f$, each constructed once and shared by all jobs
+class BasisCache
+{
+public:
+	///	@brief					No basis is constructed yet
+	///	@param	memory_limit	The memory limit of the decompositions of every basis (see \c PolynomialBasis::set_memory_limit )
+	BasisCache(size_t memory_limit) : memory_limit(memory_limit) {}
+
+	///	@brief	The basis for given \f$n\f$, constructed by the first job that needs it while the others wait
+	const basis_t &get(int n)
+	{
+		Entry *entry;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			entry = &bases[n]; //the nodes of a map never move
+		}
+		std::call_once(entry->flag, [&]() {
+			auto basis = std::make_unique<basis_t>(n, 1);
+			basis->set_memory_limit(memory_limit);
+			entry->basis = std::move(basis);
+		});
+		return *entry->basis;
+	}
+
+	///	@brief	The memory statistics of the decompositions of all jobs for given \f$n\f$ , once they all finished
+	MemoryStatistics memory_statistics(int n) const
+	{
+		const auto entry = bases.find(n);
+		return entry == bases.end() || !entry->second.basis ? MemoryStatistics() : entry->second.basis->memory_statistics();
+	}
+
+private:
+	struct Entry
+	{
+		std::once_flag flag;
+		std::unique_ptr<const basis_t> basis;
+	};
+	const size_t memory_limit;
+	std::mutex mutex;
+	std::map<int, Entry> bases;
+};
+
+///	@brief	A computation of one mode for one \f$n\f$, and its results
+struct Job
+{
+	bool pontryagin;			  ///<The mode
+	int n;						  ///<The \f$n\f$
+	double seconds = 0;			  ///<The wall time
+	std::vector<double> latencies; ///<The time of every decomposition
+	bool ok = 1;				  ///<Whether the verification and the output succeeded
+	std::string temporary;		  ///<The temporary file of its text output, if it's copied to \c stdout at the end
+
+	///	@brief	A job that hasn't run yet
+	Job(bool pontryagin, int n) : pontryagin(pontryagin), n(n) {}
+
+	///	@brief	The name of the mode
+	std::string mode() const
+	{
+		return pontryagin ? "pontryagin" : "relations";
+	}
+};
+
+///	@brief				The file of the results of a job, or of one of its shards
+///	@param	extension	Eg \c .txt
+///	@param	shard		The shard, if ```shards>1```
+///	@param	shards		The number of shards
+std::string path(const Options &options, const Job &job, const std::string &extension, size_t shard, size_t shards)
+{
+	std::string name = options.output + job.mode() + "_" + std::to_string(job.n);
+	if (shards > 1)
+		name += "." + std::to_string(shard) + "-of-" + std::to_string(shards);
+	return name + extension;
+}
+
+///	@brief	A temporary file, unique to this process, for the text output of a job
+std::string temporary_path(const Job &job)
+{
+	static const auto session = std::to_string(std::random_device()()) + "_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+	return (std::filesystem::temp_directory_path() / ("symmp_" + session + "_" + job.mode() + "_" + std::to_string(job.n) + ".txt")).string();
+}
+
+///	@brief	The text output of a job: a file, \c stdout if it's the only job running, or otherwise a temporary file
+///			that is copied to \c stdout once all jobs are done, so that the outputs of concurrent jobs don't interleave
+struct Output
+{
+	std::unique_ptr<PolynomialWriter> writer; ///<Text output, null until \ref open
+	const Options &options;					  ///<The command line options
+	Job &job;								  ///<The job
+	const bool concurrent;					  ///<Whether other jobs may be running at the same time
+
+	///	@brief	The output of a job, which is not opened yet (so no file is created or truncated)
+	Output(const Options &options, Job &job, bool concurrent) : options(options), job(job), concurrent(concurrent) {}
+
+	///	@brief	Opens the output: called once the job knows it can produce its results
+	void open()
+	{
+		if (options.format != "text")
+			return;
+		if (!options.output.empty())
+			writer = std::make_unique<PolynomialWriter>(path(options, job, ".txt", options.shard, options.shards));
+		else if (!concurrent)
+			writer = std::make_unique<PolynomialWriter>(std::cout);
+		else
+		{
+			job.temporary = temporary_path(job);
+			writer = std::make_unique<PolynomialWriter>(job.temporary);
+		}
+	}
+};
+
+///	@brief	Copies the temporary output of a job to \c stdout and removes it
+///	@return	Whether it was copied successfully
+bool copy_to_stdout(const std::string &temporary)
+{
+	bool ok = 1;
+	{
+		std::ifstream file(temporary, std::ios::binary);
+		ok = static_cast<bool>(file);
+		if (ok && file.peek() != std::ifstream::traits_type::eof()) //copying nothing would set the failbit of std::cout
+			ok = static_cast<bool>(std::cout << file.rdbuf());
+	}
+	std::remove(temporary.c_str());
+	return ok;
+}
+
+///	@brief			Whether the expansions of polynomials on the \f$\gamma_{s,j}\f$ are given polynomials
+///	@details		With \c --fast-verify only the pairs failing \c TwistedChernBasis::probable_mismatches are expanded
+///	@tparam	poly_t	The polynomial type of \p b , on the \f$x_i,y_i\f$ or on the \f$\gamma_{s,j}\f$ (then it's expanded too)
+template <class poly_t>
+bool verify(const basis_t &basis, const Options &options, int threads, const std::vector<chern_poly_t> &a, const std::vector<poly_t> &b)
+{
+	std::vector<size_t> suspects(a.size());
+	for (size_t i = 0; i < suspects.size(); i++)
+		suspects[i] = i;
+	if (options.fast_verify)
+		suspects = basis.probable_mismatches(a, b, 1, 0, threads);
+	std::vector<chern_poly_t> lhs;
+	std::vector<poly_t> rhs;
+	for (size_t i : suspects)
+	{
+		lhs.push_back(a[i]);
+		rhs.push_back(b[i]);
+	}
+	const auto expanded = basis.expand_batch(lhs, threads);
+	if constexpr (std::is_same_v<poly_t, xy_poly_t>)
+		return expanded == rhs;
+	else
+		return expanded == basis.expand_batch(rhs, threads);
+}
+
+///	@brief	Writes the relations and their decompositions
+///	@param	shard	The shard they belong to, if ```shards>1```
+///	@param	shards	The number of shards
+void write_relations(const Options &options, Job &job, Output &out, std::vector<chern_poly_t> lhs, const std::vector<chern_poly_t> &rhs, size_t shard, size_t shards)
+{
+	if (out.writer)
+		for (size_t i = 0; i < lhs.size(); i++)
+			*out.writer << lhs[i] << " = " << rhs[i] << '\n';
+	if (options.format == "binary")
+	{ //the left sides followed by the right sides
+		lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+		job.ok = save_polynomials(path(options, job, ".bin", shard, shards), lhs) && job.ok;
+	}
+}
+
+///	@brief	Computes the relations of the twisted Chern classes (of the shard given in the command line) for the \f$n\f$ of a job
+void relations(const basis_t &basis, const Options &options, int threads, Job &job, Output &out)
+{
+	const auto shard = basis.relation_shard(options.shard, options.shards, options.balanced);
+	std::vector<chern_poly_t> lhs;
+	size_t k = 0;
+	const auto range = basis.relations();
+	for (auto it = range.begin(); it != range.end() && lhs.size() < shard.size(); ++it, k++)
+		if (k == shard[lhs.size()])
+			lhs.push_back(*it);
+	const auto ps = basis.expand_batch(lhs, threads);
+	const auto qs = basis.decompose_batch(ps, threads, &job.latencies);
+	if (options.verify) //the relations are compared directly with their decompositions, which saves evaluating the expansions
+		job.ok = options.fast_verify ? verify(basis, options, threads, lhs, qs) : verify(basis, options, threads, qs, ps);
+	write_relations(options, job, out, std::move(lhs), qs, options.shard, options.shards);
+}
+
+///	@brief	Collects the relations computed by the shards of a job, and writes them as the unsharded computation would
+///	@note	The binary file is the same as that of the unsharded computation; the text has the same polynomials, but the terms may be printed in another order
+void merge(const basis_t &basis, const Options &options, int threads, Job &job, Output &out)
+{
+	std::vector<chern_poly_t> lhs;
+	for (auto rel : basis.relations())
+		lhs.push_back(std::move(rel));
+	std::vector<chern_poly_t> rhs(lhs.size());
+	//every shard is read and checked before the output is opened, so that a failed merge leaves an earlier output intact
+	for (size_t shard = 0; shard < options.merge; shard++)
+	{
+		const auto indices = basis.relation_shard(shard, options.merge, options.balanced);
+		const auto file = path(options, job, ".bin", shard, options.merge);
+		auto loaded = load_polynomials<chern_poly_t>(file, basis.dimensions().data(), basis.names().data());
+		//the left sides tell if the file is of another shard, number of shards or balance
+		bool matches = loaded && loaded->size() == 2 * indices.size();
+		for (size_t k = 0; matches && k < indices.size(); k++)
+			matches = (*loaded)[k] == lhs[indices[k]];
+		if (!matches)
+		{
+			std::cerr << "cannot merge " << file << ": missing, or not computed with the same number of shards and balance\n";
+			job.ok = 0;
+			return;
+		}
+		for (size_t k = 0; k < indices.size(); k++)
+			rhs[indices[k]] = std::move((*loaded)[indices.size() + k]);
+	}
+	if (options.verify)
+		job.ok = verify(basis, options, threads, lhs, rhs);
+	out.open();
+	write_relations(options, job, out, std::move(lhs), rhs, 0, 1);
+}
+
+///	@brief	Writes the twisted Pontryagin classes in terms of the twisted Chern classes for the \f$n\f$ of a job
+void pontryagin(const basis_t &basis, const Options &options, int threads, Job &job, Output &out)
+{
+	std::vector<std::array<int, 2>> indices;
+	std::vector<xy_poly_t> classes;
+	for (int s = 1; s <= job.n; s++)
+		for (int i = 1; i <= job.n - s; i++)
+		{
+			const auto &chern = basis.generator(s, i);
+			xy_poly_t pontryagin;
+			for (auto it = chern.begin(); it != chern.end(); ++it)
+				pontryagin.insert(it.exponent() + it.exponent(), it.coeff());
+			indices.push_back({s, i});
+			classes.push_back(std::move(pontryagin));
+		}
+	const auto decomposed = basis.decompose_batch(classes, threads, &job.latencies);
+	if (options.verify)
+		job.ok = verify(basis, options, threads, decomposed, classes);
+	if (out.writer)
+		for (size_t k = 0; k < indices.size(); k++)
+			*out.writer << "k_{" << indices[k][0] << "," << indices[k][1] << "}= " << decomposed[k] << '\n';
+	if (options.format == "binary")
+		job.ok = save_polynomials(path(options, job, ".bin", 0, 1), decomposed) && job.ok;
+}
+
+///	@brief	The peak resident memory of the process in bytes, or 0 if unknown
+size_t peak_memory()
+{
+#if defined(__APPLE__)
+	rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<size_t>(usage.ru_maxrss) : 0;
+#elif defined(__unix__)
+	rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<size_t>(usage.ru_maxrss) * 1024 : 0;
+#else
+	return 0;
+#endif
+}
+
+///	@brief				The nearest-rank percentile of sorted values
+///	@param	sorted		The values in increasing order (nonempty)
+///	@param	percentile	The percentile in \f$(0,100]\f$
+double percentile(const std::vector<double> &sorted, double percentile)
+{
+	const size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * sorted.size()));
+	return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+///	@brief	Runs the jobs given in the command line
+int main(int argc, char **argv)
+{
+	Options options;
+	if (!parse(argc, argv, options))
+	{
+		std::cerr << "Usage: Driver [--mode relations|pontryagin|both] [--n N|N1-N2|N1,N2,...] [--threads T] [--jobs J] "
+					 "[--format text|binary|none] [--output PREFIX] [--verify|--fast-verify] [--shard I/K|--merge K] [--balance] [--memory-limit MIB]\n"
+					 "(binary output and --merge need --output; --shard and --merge only apply to --mode relations)\n";
+		return 2;
+	}
+	std::vector<Job> jobs;
+	for (int n : options.ns)
+	{
+		if (options.relations)
+			jobs.emplace_back(0, n);
+		if (options.pontryagin)
+			jobs.emplace_back(1, n);
+	}
+	const int workers = std::min<int>(options.jobs, static_cast<int>(jobs.size()));
+	//if several jobs run at once the largest start first; otherwise they run in order, writing straight to stdout
+	std::vector<size_t> order(jobs.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	if (workers > 1)
+		std::stable_sort(order.begin(), order.end(), [&](size_t i, size_t j) { return jobs[i].n > jobs[j].n; });
+	const int threads = options.threads == 0 ? 0 : std::max(1, options.threads / workers);
+
+	BasisCache bases(options.memory_limit);
+	std::atomic<size_t> next(0);
+	const auto start = std::chrono::steady_clock::now();
+	const auto work = [&]() {
+		for (size_t k; (k = next++) < order.size();)
+		{
+			auto &job = jobs[order[k]];
+			const auto job_start = std::chrono::steady_clock::now();
+			Output out(options, job, workers > 1);
+			if (options.merge == 0 || job.pontryagin) //a merge opens its output once the shards are checked
+				out.open();
+			const auto &basis = bases.get(job.n);
+			if (job.pontryagin)
+				pontryagin(basis, options, threads, job, out);
+			else if (options.merge != 0)
+				merge(basis, options, threads, job, out);
+			else
+				relations(basis, options, threads, job, out);
+			if (out.writer)
+			{
+				out.writer->flush();
+				job.ok = job.ok && out.writer->good();
+			}
+			job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - job_start).count();
+		}
+	};
+	std::vector<std::thread> pool;
+	for (int i = 1; i < workers; i++)
+		pool.emplace_back(work);
+	work();
+	for (auto &thread : pool)
+		thread.join();
+	for (auto &job : jobs) //by increasing n, as they were listed
+		if (!job.temporary.empty())
+			job.ok = copy_to_stdout(job.temporary) && job.ok;
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout.flush();
+
+	bool ok = 1;
+	std::cerr << std::fixed << std::setprecision(6);
+	for (auto &job : jobs)
+	{
+		std::sort(job.latencies.begin(), job.latencies.end());
+		std::cerr << job.mode() << " n=" << job.n;
+		if (options.shards > 1)
+			std::cerr << " shard " << options.shard << "/" << options.shards;
+		else if (options.merge != 0)
+			std::cerr << " merged from " << options.merge << " shards";
+		std::cerr << ": " << job.latencies.size() << " decompositions in " << job.seconds << " s";
+		if (!job.latencies.empty())
+			std::cerr << ", latency p50 " << percentile(job.latencies, 50) << " s, p90 " << percentile(job.latencies, 90)
+					  << " s, p99 " << percentile(job.latencies, 99) << " s, max " << job.latencies.back() << " s";
+		if (options.verify)
+			std::cerr << (job.ok ? ", verified" : ", FAILED");
+		else if (!job.ok)
+			std::cerr << ", output FAILED";
+		std::cerr << "\n";
+		ok = ok && job.ok;
+	}
+	std::cerr << "wall time " << seconds << " s, peak memory " << std::setprecision(1) << peak_memory() / 1048576.0 << " MiB\n";
+	for (int n : options.ns)
+	{ //the footprint is only tracked with a limit
+		const auto memory = bases.memory_statistics(n);
+		if (options.memory_limit != 0 && memory.decompositions != 0)
+			std::cerr << "n=" << n << ": decomposition peak " << std::setprecision(3) << memory.peak_bytes / 1048576.0 << " MiB (estimated), "
+					  << memory.streamed << " of " << memory.decompositions << " decompositions streamed\n";
+	}
+#if defined(SYMMP_INSTRUMENT)
+	std::cerr << std::setprecision(6) << instrumentation_report();
+#endif
+	return ok ? 0 : 1;
+}
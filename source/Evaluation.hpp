@@ -0,0 +1,86 @@
+#pragma once
+#include "Polynomials.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains the numerical evaluation of polynomials at batches of points
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			A polynomial compiled into a flat list of multiplications, for evaluating it at many points
+	///	@details		The monomials are arranged in a tree where the children of a monomial multiply it by a power of a later variable,
+	///					so monomials sharing their first variables share their partial products (like Horner's scheme), and the powers of every
+	///					variable are computed once per point. The plan lists the nodes of the tree depth first, so evaluating only needs the
+	///					partial products along one path.
+	///
+	///					Points are evaluated in blocks of \ref block at once: the points are given in structure-of-arrays layout
+	///					(all values of the first variable, then all values of the second ...) and every step of the plan is a loop over the
+	///					block with no dependencies between its iterations, which the compiler vectorizes for \c double and integers.
+	///	@tparam value_t	The type of the values eg \c double , \c int64_t or \c ModularInteger ; it must be constructible from the coefficients and from \c 0
+	///	@note			Only the exponents are used, so this works for any exponent type eg \c StandardVariables or \c TwistedChernVariables
+	///					(whose degrees come from the dimensions given to the polynomials), but the relations of the variables are not:
+	///					eg the \f$y_i\f$ of \c HalfIdempotentVariables should only take the values 0 and 1.
+	///	@note			A plan is immutable, so several threads can evaluate it at once.
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class value_t>
+	class EvaluationPlan
+	{
+	public:
+		static constexpr size_t block = 64; ///<The number of points evaluated at once
+
+		///	@brief	Constructs the plan of the zero polynomial
+		EvaluationPlan();
+
+		///	@brief						Compiles a polynomial
+		///	@tparam	container_t			The data storage type of the polynomial eg \c DefaultContainer
+		///	@param	a					The polynomial
+		///	@param	number_of_variables	The number of variables of the points; at least the number of variables of the exponents of \p a is used
+		template <class container_t>
+		explicit EvaluationPlan(const Polynomial<container_t> &a, int number_of_variables = 0);
+
+		///	@brief	The number of variables of a point
+		int number_of_variables() const;
+
+		///	@brief	The number of multiplications per point (the powers of the variables included)
+		size_t number_of_multiplications() const;
+
+		///	@brief			Evaluates at one point
+		///	@param	point	The values of the variables, at least \ref number_of_variables of them
+		///	@return			The value of the polynomial
+		value_t operator()(const std::vector<value_t> &point) const;
+
+		///	@brief			Evaluates at a batch of points in structure-of-arrays layout
+		///	@param	points	The value of variable \c v at point \c p is ```points[v * count + p]``` (for \f$v<\f$ \ref number_of_variables )
+		///	@param	count	The number of points
+		///	@param	results	Where the \p count values are written
+		void evaluate(const value_t *points, size_t count, value_t *results) const;
+
+		///	@brief				Evaluates at a batch of points in structure-of-arrays layout
+		///	@param	variables	The value of variable \c v at point \c p is ```variables[v][p]``` ; all have the same size
+		///	@return				The values of the polynomial at the points
+		std::vector<value_t> evaluate(const std::vector<std::vector<value_t>> &variables) const;
+
+	private:
+		struct Step
+		{
+			uint32_t depth;	  //the node computed is the product at this depth of the path
+			uint32_t power;	  //times this entry of the table of powers
+			int64_t monomial; //the index of its coefficient if the node is a monomial, and -1 otherwise
+		};
+		int variables;
+		uint32_t max_depth;
+		value_t constant;
+		std::vector<value_t> coefficients;
+		std::vector<uint32_t> max_exponent; //of each variable; its powers start at power_offset in the table
+		std::vector<uint32_t> power_offset;
+		uint32_t powers;
+		std::vector<Step> steps;
+	};
+}
+#include "impl/Evaluation.ipp"
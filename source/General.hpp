@@ -1,11 +1,25 @@
 #pragma once
 #include <numeric>
 #include <iostream>
+#include <cstdint>
+#include <array>
 
-#if defined(__GNUC__)
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(_M_X64))
+///	@brief	Defined if the x86 CRC32 instruction (SSE4.2) is used by \c crc
+#define SYMMP_CRC32_X86
+#if defined(_MSC_VER)
+#include "intrin.h"
+#else
 #include "x86intrin.h"
-#elif defined(_MSC_VER)
+#endif
+#elif defined(__ARM_FEATURE_CRC32) || (defined(_MSC_VER) && defined(_M_ARM64))
+///	@brief	Defined if the ARMv8 CRC32 instructions are used by \c crc
+#define SYMMP_CRC32_ARM
+#if defined(_MSC_VER)
 #include "intrin.h"
+#else
+#include "arm_acle.h"
+#endif
 #endif
 
 ///	@file
@@ -15,15 +29,20 @@
 namespace symmp
 {
 
-	///	@brief	Hash algorithm CRC32. SSE4.1 and up
+	///	@brief	Hash algorithm CRC32C (Castagnoli). Uses the SSE4.2 or the ARMv8 CRC32 instructions if available and a lookup table otherwise, with the same result
 	struct crc;
 
 	///	@brief	Hash algorithm using golden ratio (idea from boost)
 	struct boost_hash;
 
+	///	@brief	Hash algorithm in the style of wyhash: every element is mixed in with a 64x64 to 128 bit multiplication, folding the two halves
+	///	@note	Best suited to few wide elements, eg the packed words of a \c PackedExponent, where it costs one multiplication per word
+	struct wy_hash;
+
 	///	@brief			A generic hashing function that calls other hashing functions.
 	///	@tparam	T		The type of element to be hashed (must have a for range loop)
-	///	@tparam	hasher	The hashing algorithm. \c boost_hash by default. If SSE4.1 is supported you can also use \c crc
+	///	@tparam	hasher	The hashing algorithm: \c boost_hash by default, \c crc or \c wy_hash .
+	///					Any type with static methods \c initialize() , \c combine(size_t&,value) and \c finalize(size_t) can be used.
 	///	@param	v		The element to be hashed
 	///	@return			The hash of the element
 	template <typename T, typename hasher = boost_hash>
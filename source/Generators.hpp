@@ -16,8 +16,7 @@ namespace symmp
 	///					You will also need \c begin() and \c end() methods returning such iterators;
 	///					\c end() should always be defined by calling the factory \c end() .\n
 	///					Example implementations: \c CombinationGenerator and \c PermutationGenerator
-	///	@attention		Probably not thread-safe (depends on specialization's \c update() method).
-	///	@todo			Implement as coroutine (C++20)
+	///	@attention		Each iterator holds its own state, so several threads can iterate at once (if the specialization's \c update() method only touches the iterator).
 	///	@tparam	spec_t	Used for compile-time polymorphism (CRTP): set it to be the child class.
 	///	@tparam	gen_t	The type of the generated element.
 	////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -37,25 +36,37 @@ namespace symmp
 	////////////////////////////////////////////////////////////////////////////////////////
 	///	@brief		Generates all permutations on a number of letters
 	///	@details	Use with a ranged for loop: If \c v is a \c PermutationGenerator object then in
-	///				\code for (const auto& i:v) {...} \endcode the variable \c i will range over all permutations.
-	///	@warning	Not thread safe!
-	///	@todo		Implement via coroutine (C++20)
+	///				\code for (const auto& i:v) {...} \endcode the variable \c i will range over all permutations, in lexicographic order.\n
+	///				The permutations are also addressable by their rank in that order (see \ref unrank and \ref slice),
+	///				so that the generation can be split across threads: \c v.slice(first,last) generates the permutations of rank in \f$[first,last)\f$.
 	///	@tparam T	The data type of our permutations eg \c std::vector<int>
 	//////////////////////////////////////////////////////////////////////////////////
 	template <class T>
 	class PermutationGenerator
 	{
 		const T n;
+		size_t first, last;
 
 	public:
-		/// @brief	Computes total number of permutations
-		/// @return Factorial \f$n!\f$ where \f$n\f$ is the number of letters
+		/// @brief	Computes number of generated permutations
+		/// @return Factorial \f$n!\f$ where \f$n\f$ is the number of letters (or the size of the slice)
 		size_t size() const;
 
 		///	@brief		Constructor sets up the generator
 		///	@param n	The total number of letters
 		PermutationGenerator(T n);
 
+		///	@brief			The permutation of given rank in lexicographic order (via the factorial number system)
+		///	@param rank		The rank, less than \f$n!\f$
+		///	@return			The permutation
+		std::vector<T> unrank(size_t rank) const;
+
+		///	@brief			Generator of the permutations with rank in \f$[first,last)\f$ (relative to \c *this )
+		///	@param first	The rank of the first generated permutation
+		///	@param last		One more than the rank of the last generated permutation
+		///	@return			The sliced generator
+		PermutationGenerator slice(size_t first, size_t last) const;
+
 		///	@brief		Constant iterator that is used in a ranged for loop to generate the permutations.
 		///	@warning	Non constant version is illegal
 		class ConstIterator : public FactoryGenerator<PermutationGenerator::ConstIterator, std::vector<T>>
@@ -63,6 +74,7 @@ namespace symmp
 			void update();
 			friend class PermutationGenerator;													///<Befriending outer class
 			friend class FactoryGenerator<PermutationGenerator::ConstIterator, std::vector<T>>; ///<Befriending parent
+			size_t remaining = 0;
 		};
 
 		/// @brief	Begin iterator
@@ -77,26 +89,41 @@ namespace symmp
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	///	@brief		Generates all combinations on a number of letters making a number of choices
 	///	@details	Use with a ranged for loop: If \c v is a \c CombinationGenerator object then in
-	///				\code for (const auto& i:v) {...} \endcode the variable \c i will range over all combinations.
-	///	@warning	Not thread safe!
-	///	@todo		Implement via coroutine (C++20)
+	///				\code for (const auto& i:v) {...} \endcode the variable \c i will range over all combinations, in lexicographic order.\n
+	///				The combinations are also addressable by their rank in that order (see \ref unrank and \ref slice),
+	///				so that the generation can be split across threads: \c v.slice(first,last) generates the combinations of rank in \f$[first,last)\f$.
 	///	@tparam  T	The data type of our combinations eg \c std::vector<int>
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	template <class T>
 	class CombinationGenerator
 	{
 		const T total, choices;
+		size_t first, last;
 
 	public:
-		///	@brief	Computes total number of combinations
-		///	@return Binomial \f${n}\choose{k}\f$ where \f$n\f$=total and \f$k\f$=choices
-		auto size() const;
+		///	@brief	Computes number of generated combinations
+		///	@return Binomial \f${n}\choose{k}\f$ where \f$n\f$=total and \f$k\f$=choices (or the size of the slice)
+		size_t size() const;
 
 		///	@brief			Sets up the generator
 		///	@param total	The number of letters
 		///	@param choices	The number of choices
 		CombinationGenerator(T total, T choices);
 
+		///	@brief			The combination of given rank in lexicographic order (via the combinatorial number system)
+		///	@param rank		The rank, less than \f${n}\choose{k}\f$
+		///	@return			The combination (increasing)
+		std::vector<T> unrank(size_t rank) const;
+
+		///	@brief			Generator of the combinations with rank in \f$[first,last)\f$ (relative to \c *this )
+		///	@param first	The rank of the first generated combination
+		///	@param last		One more than the rank of the last generated combination
+		///	@return			The sliced generator
+		CombinationGenerator slice(size_t first, size_t last) const;
+
+		///	@brief		The binomial coefficient \f${n}\choose{k}\f$ (0 if \f$k>n\f$)
+		static size_t binomial(size_t n, size_t k);
+
 		///	@brief		Constant iterator that is used in a ranged for loop to generate the combinations.
 		///	@warning	Non \c const version is illegal
 		class ConstIterator : public FactoryGenerator<CombinationGenerator::ConstIterator, std::vector<T>>
@@ -105,6 +132,7 @@ namespace symmp
 			friend class CombinationGenerator;													///<Befriending outer class
 			friend class FactoryGenerator<CombinationGenerator::ConstIterator, std::vector<T>>; ///<Befriending parent
 			T total, choices;
+			size_t remaining = 0;
 		};
 
 		/// @brief	Begin iterator
@@ -1,6 +1,9 @@
 #pragma once
 #include "Symmetric_Basis.hpp"
-#include <sstream>
+#include "Polynomial_Writer.hpp"
+#include "Scalars.hpp"
+#include "Evaluation.hpp"
+#include <random>
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///	@file
@@ -16,14 +19,6 @@
 namespace symmp
 {
 
-	/////////////////////////////////////////////////////////////////////////
-	///	@brief		Wrapping array and vector in the same interface
-	///	@tparam T	The value type of the array/vector
-	///	@tparam N	The size if it's an array or 0 if it's a vector
-	/////////////////////////////////////////////////////////////////////////
-	template <class T, size_t N = 0>
-	struct ArrayVectorWrapper;
-
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	///	@brief			Variables \f$x_1,...,x_n,y_1,...,y_n\f$ with \f$y_i^2=y_i\f$ and \f$|x_i|=1\f$, \f$|y_i|=0\f$
 	///	@details		Monomial \f$x_1^{a_1}\cdots x_n^{a_n}y_1^{a_{n+1}}\cdots y_n^{a_{2n}}\f$ is stored as vector/array \f$[a_1,...,a_{2n}]\f$
@@ -41,6 +36,11 @@ namespace symmp
 		/// @return		Exponent \f$[a_1+b_1,...,a_n+b_n, \max(a_{n+1},b_{n+1}), ..., \max(a_{2n},b_{2n})]\f$
 		HalfIdempotentVariables operator+(const HalfIdempotentVariables &b) const;
 
+		/// @brief		Multiplies monomials in place by adding their exponents
+		/// @param  b	The exponent \f$[b_1,...,b_{2n}]\f$ we add to ```*this``` =\f$[a_1,...,a_{2n}]\f$
+		/// @return		Reference to ```*this``` =\f$[a_1+b_1,...,a_n+b_n, \max(a_{n+1},b_{n+1}), ..., \max(a_{2n},b_{2n})]\f$
+		HalfIdempotentVariables &operator+=(const HalfIdempotentVariables &b);
+
 		///	@brief		Divides monomials by subtracting their exponents
 		///	@param	b	The exponent \f$[b_1,...,b_{2n}]\f$ we subtract from ```*this``` =\f$[a_1,...,a_{2n}]\f$.
 		///	@warning	We must have \f$b_i\le a_i\f$ for every \f$i\f$.
@@ -70,11 +70,12 @@ namespace symmp
 	///	@note			This class does NOT provide functions for degrees or variable names: these are provided as pointers directly in TwistedChernBasis
 	///	@tparam T 		The (integral) value type of the exponent vector.
 	///	@tparam _deg	The (integral) value type used in the degree function.
+	///	@tparam N 		The number of variables in compile-time; set to 0 if unknown (default). Otherwise N=\f$n+n(n+1)/2\f$.
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	template <class T = int64_t, class _deg = int64_t>
-	struct TwistedChernVariables : public std::vector<T>
+	template <class T = int64_t, class _deg = int64_t, size_t N = 0>
+	struct TwistedChernVariables : public ArrayVectorWrapper<T, N>
 	{
-		using std::vector<T>::vector;
+		using ArrayVectorWrapper<T, N>::ArrayVectorWrapper;
 		typedef _deg deg_t; ///<Degree typedef
 
 		///	@brief		Multiplies monomials by adding their exponents.
@@ -83,6 +84,11 @@ namespace symmp
 		///	@return		Exponent \f$[a_{0,1}+b_{0,1},...,a_{n,0}+b_{n,0}]\f$
 		TwistedChernVariables operator+(const TwistedChernVariables &b) const;
 
+		///	@brief		Multiplies monomials in place by adding their exponents.
+		///	@param 	b	The exponent \f$[b_{0,1},...,b_{n,0}]\f$ we add to ```*this```=\f$[a_{0,1},...,a_{n,0}]\f$
+		///	@return		Reference to ```*this```=\f$[a_{0,1}+b_{0,1},...,a_{n,0}+b_{n,0}]\f$
+		TwistedChernVariables &operator+=(const TwistedChernVariables &b);
+
 		/// @brief	Hashes monomial
 		/// @return Hash of exponent vector (calls \ref generic_hasher)
 		size_t operator()() const;
@@ -90,22 +96,72 @@ namespace symmp
 
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	///	@brief						Class for half-idempotent symmetric polynomials
-	///	@details					Facilitates transformation from \f$x_i,y_i\f$ variables to \f$\gamma_{s,i}\f$ variables and vice-versa.
+	///	@details					Facilitates transformation from \f$x_i,y_i\f$ variables to \f$\gamma_{s,i}\f$ variables and vice-versa.\n
+	///								If the exponents have compile-time size (see \c FixedTwistedChernBasis) then no exponent touches the heap
+	///								and the loops over the variables have compile-time bounds.
 	///	@tparam xy_poly_t			The container type on the HalfIdempotentVariables \f$x_i,y_i\f$
 	///	@tparam chern_poly_t		The container type on the TwistedChernVariables \f$\gamma_{s,j}\f$
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	template <class xy_poly_t, class chern_poly_t>
 	class TwistedChernBasis : public PolynomialBasis<TwistedChernBasis<xy_poly_t, chern_poly_t>, xy_poly_t, chern_poly_t>
 	{
+		typedef typename xy_poly_t::exp_t xy_t;
+		typedef typename chern_poly_t::exp_t chern_t;
+		//n if the exponents have compile-time size and 0 otherwise
+		static constexpr int fixed_n = implementation_details::static_size<xy_t>::value / 2;
+
 	public:
-		///	@brief		Constructs the generators and the relation set given \f$n\f$ in \f$x_1,...,x_n,y_1,...,y_n\f$.
-		///	@param n	Half(!) the number of variables
+		///	@brief		Lazy range of the relations: each relation is only constructed when an iterator to it is dereferenced
+		///	@details	Use with a ranged for loop or pass it to \c expand_batch ; the relations come in the order of increasing \f$(s,t,i,j)\f$
+		class RelationRange
+		{
+		public:
+			///	@brief	Forward iterator over the relations
+			class ConstIterator
+			{
+			public:
+				chern_poly_t operator*() const;					   ///<Constructs the current relation
+				ConstIterator &operator++();					   ///<Moves to the next relation
+				bool operator!=(const ConstIterator &other) const; ///<Inequality of iterators (used to detect if all relations have been generated)
+
+			private:
+				ConstIterator(const TwistedChernBasis *basis, int s);
+				void advance(); //moves to the next (s,t,i,j), relation or not
+				bool is_relation() const;
+				const TwistedChernBasis *basis;
+				int s, t, i, j;
+				friend class RelationRange; ///<Befriending outer class
+			};
+
+			/// @brief	Begin iterator
+			/// @return An iterator to the first relation
+			ConstIterator begin() const;
+
+			/// @brief	End iterator
+			/// @return An iterator to the end of the range
+			ConstIterator end() const;
+
+			///	@brief	The number of relations (counted without constructing them)
+			size_t size() const;
+
+		private:
+			RelationRange(const TwistedChernBasis *basis);
+			const TwistedChernBasis *basis;
+			friend class TwistedChernBasis; ///<Befriending outer class
+		};
+
+		///	@brief		Constructs the generators given \f$n\f$ in \f$x_1,...,x_n,y_1,...,y_n\f$.
+		///	@param n	Half(!) the number of variables; defaults to half the compile-time size of the exponents (if any)
+		///	@param lazy	Whether each generator is only constructed the first time it's needed (by \ref generator or by an expansion/decomposition using it).
+		///				Useful for large \f$n\f$ when only a few generators are used.
 		///	@attention	The parameter \c n is half(!) the number of variables (the \f$n\f$ in \f$BU(n)\f$)
-		TwistedChernBasis(int n);
+		///	@warning	Calls \c abort() if \p n doesn't match the compile-time size of the exponents
+		TwistedChernBasis(int n = fixed_n, bool lazy = 0);
 
 		///	@brief		The relations  are \f$\gamma_{s,i}\gamma_{t,j}\f$ for \f$0<s<=t<=s+i\f$ and \f$i,j>0\f$
-		///	@return		const& to vector containing the relation Polynomials \f$\gamma_{s,i}\gamma_{t,j}\f$
-		const std::vector<chern_poly_t> &relations() const;
+		///	@return		Lazy range of the relation Polynomials \f$\gamma_{s,i}\gamma_{t,j}\f$
+		///	@note		Nothing is stored: the relations are constructed while iterating (the range is valid as long as \c *this is)
+		RelationRange relations() const;
 
 		///	@brief		The generator \f$\gamma_{s,j}\f$.
 		/// @param s	The index of \f$s\f$ of \f$\gamma_{s,j}\f$.
@@ -113,41 +169,83 @@ namespace symmp
 		/// @return		const& to the polynomial \f$\gamma_{s,j}\f$ on the \f$x_i,y_i\f$ variables
 		const xy_poly_t &generator(int s, int j) const;
 
+		///	@brief			Finds which expansions of polynomials on the \f$\gamma_{s,j}\f$ differ from given polynomials, without expanding them (Schwartz-Zippel)
+		///	@details		Both sides are evaluated modulo a prime close to \f$2^{62}\f$ at random \f$x_i\f$, and at the \f$n+1\f$ points where
+		///					\f$y_1=\cdots=y_k=1\f$ and \f$y_{k+1}=\cdots=y_n=0\f$ (the only values of the \f$y_i\f$ compatible with \f$y_i^2=y_i\f$ are 0 and 1;
+		///					as both sides are symmetric, these \f$n+1\f$ points see the lowest nonzero coefficient in the \f$y_i\f$ of any difference).
+		///					The side on the \f$\gamma_{s,j}\f$ is evaluated at the values of the generators, so evaluating every generator once a point
+		///					replaces the expansions of \c expand_batch .
+		///	@tparam	poly_t	Either \c xy_poly_t (eg to check decompositions) or \c chern_poly_t (eg to check the relations, whose sides are both on the \f$\gamma_{s,j}\f$)
+		///	@param	a		Polynomials on the \f$\gamma_{s,j}\f$
+		///	@param	b		Polynomials compared to the expansions of \p a , as many as in \p a
+		///	@param	rounds	The number of random points of the \f$x_i\f$
+		///	@param	seed	The seed of the random points, so the result is reproducible
+		///	@param	threads	The number of threads evaluating; 0 uses the openMP default
+		///	@return			The indices \c i , in increasing order, where the expansion of ```a[i]``` certainly differs from ```b[i]``` : for the others the sides are equal except
+		///					with probability at most \f$(d/p)^{rounds}\f$ where \f$d\f$ is the degree of the difference and \f$p\f$ the prime
+		///	@note			The coefficients must be integers. The evaluation is exact modulo the prime, so if they have overflowed the symbolic
+		///					verification (of the coefficients modulo \f$2^{64}\f$) may still succeed: verify the indices returned symbolically before reporting them.
+		template <class poly_t>
+		std::vector<size_t> probable_mismatches(const std::vector<chern_poly_t> &a, const std::vector<poly_t> &b, int rounds = 1, uint64_t seed = 0, int threads = 0) const;
+
+		///	@brief				Splits the relations into shards, eg to compute them in independent processes
+		///	@details			Either the \f$k\f$-th relation of \ref relations goes to shard \f$k\bmod shards\f$, or the shards are balanced by cost:
+		///						the relations are dealt in decreasing estimated cost (the number of products of monomials of their expansion, times their degree plus one)
+		///						to the shard with the least total cost so far. The partition only depends on \f$n\f$ and \p shards ,
+		///						so every process computes the same one without any coordination.
+		///	@param	shard		The shard, from 0 to ```shards-1```
+		///	@param	shards		The number of shards
+		///	@param	balanced	Whether to balance the shards by cost rather than taking every \p shards -th relation
+		///	@return				The indices of the relations (in the order of \ref relations ) in the shard, in increasing order
+		///	@note				Balancing constructs every generator, to count its monomials
+		///	@warning			Calls \c abort() unless ```shard<shards```
+		std::vector<size_t> relation_shard(size_t shard, size_t shards, bool balanced = 0) const;
+
+		using PolynomialBasis<TwistedChernBasis<xy_poly_t, chern_poly_t>, xy_poly_t, chern_poly_t>::generator;
+
 		///	@brief	Befriending parent for CRTP.
 		friend class PolynomialBasis<TwistedChernBasis<xy_poly_t, chern_poly_t>, xy_poly_t, chern_poly_t>;
 
 	private:
-		typedef typename xy_poly_t::exp_t xy_t;
-		typedef typename chern_poly_t::exp_t chern_t;
-		using PolynomialBasis<TwistedChernBasis<xy_poly_t, chern_poly_t>, xy_poly_t, chern_poly_t>::_generators;
 		using PolynomialBasis<TwistedChernBasis<xy_poly_t, chern_poly_t>, xy_poly_t, chern_poly_t>::generator_names;
 		using PolynomialBasis<TwistedChernBasis<xy_poly_t, chern_poly_t>, xy_poly_t, chern_poly_t>::generator_dimensions;
 
 		const int n;					//Half the variable number
-		const int number_of_generators; //Number of c_{s,j}
-		std::vector<chern_poly_t> _relations;
+		const int generator_count; //Number of c_{s,j}
 
-		//Takes (s,j) to the index in the _generators vector
-		std::map<std::array<int, 2>, int> generator_double_index;
+		//n, as a compile-time constant when the exponents have compile-time size
+		int half() const;
 		//Transforms index (s,j) of c_{s,j} into the corresponding index in the generators vector.
+		//The c_{s,j} are ordered lexicographically in (s,j) skipping c_{0,0}, so this is closed-form.
+		static constexpr int index(int n, int s, int j);
 		int index(int s, int j) const;
-		auto create_generator(int s, int i);
-		void set_generators();
-		void set_relations();
+		xy_poly_t create_generator(int s, int i) const;
+		xy_poly_t make_generator(size_t i) const;
+		void set_generators(bool lazy);
 		auto find_exponent(const xy_t &term) const;
-		void find_exponent_recursive(const xy_t &term, chern_t &exponent) const;
 	};
 
 	///	@brief					Prints the relations of \f$\Big(\mathbf Z[x_1,...,x_n,y_1,...,y_n]/(y_i^2=y_i)\Big)^{\Sigma_n}\f$
 	///	@details				The generators \f$\alpha_i, c_i, \gamma_{s,j}\f$ are printed as ``` a_i, c_i, c_{s,j} ``` in the console.
+	///							The relations are expanded, decomposed, verified and printed in windows of a few per thread, so the memory used doesn't grow with their number;
+	///							within a window each relation is printed as soon as it and those before it are done.
 	///	@tparam xy_poly_t		The type of polynomial on the \f$x_i,y_i\f$ variables
 	///	@tparam chern_poly_t	The type of polynomial on the \f$\gamma_{s,j}\f$ variables
 	///	@param n				Half the number of variables (the \f$n\f$)
 	///	@param print			Whether we want to print the relations to the console
 	///	@param verify			Whether to verify the relations
 	///	@param verify_verbose	Whether to verify and print the verification to the console
+	///	@param probabilistic	Whether to verify with \c TwistedChernBasis::probable_mismatches , which is much faster; only the relations failing it are verified symbolically
 	template <class xy_poly_t, class chern_poly_t>
-	void print_half_idempotent_relations(int n, bool print = 1, bool verify = 1, bool verify_verbose = 1);
+	void print_half_idempotent_relations(int n, bool print = 1, bool verify = 1, bool verify_verbose = 1, bool probabilistic = 0);
+
+	///	@brief			\c TwistedChernBasis for \f$n\f$ fixed in compile-time, with exponents stored in \c std::array
+	///	@tparam n		Half the number of variables (the \f$n\f$ in \f$BU(n)\f$)
+	///	@tparam _scl	The scalar/coefficient type of the polynomials
+	///	@tparam T		The (integral) value type of the exponents
+	///	@tparam _deg	The (integral) value type used in the degree function
+	template <size_t n, class _scl = int64_t, class T = int64_t, class _deg = int64_t>
+	using FixedTwistedChernBasis = TwistedChernBasis<GradedPoly<_scl, HalfIdempotentVariables<T, _deg, 2 * n>>, GradedPoly<_scl, TwistedChernVariables<T, _deg, n + (n * n + n) / 2>>>;
 
 }
 #include "impl/Half_Idempotent.ipp"
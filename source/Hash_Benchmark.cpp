@@ -0,0 +1,158 @@
+#include "Packed_Variables.hpp"
+
+#include <chrono>
+#include <unordered_set>
+#include <iomanip>
+#include <cmath>
+
+///	@file
+///	@brief	A benchmark of the hashing algorithms on the monomials of the half idempotent relations, that can be compiled
+///	@details	For every algorithm it reports the time per hash, the number of full 64 bit collisions, the average and maximum
+///				number of keys examined by a successful lookup in a \c std::unordered_set (its probe length) and the fraction of
+///				occupied slots in a power of 2 table indexed by the low bits of the hash. Usage: ```Hash_Benchmark [n]``` (default 5, up to 8)
+
+using namespace symmp;
+
+///	@brief			Hashes an exponent with a given algorithm
+///	@tparam	hasher	The hashing algorithm eg \c wy_hash
+template <class hasher>
+struct hash_with
+{
+	///	@brief	Hash of an exponent stored in a vector or array
+	template <class T>
+	auto operator()(const T &exponent) const -> decltype(std::begin(exponent), size_t())
+	{
+		return generic_hasher<T, hasher>(exponent);
+	}
+
+	///	@brief	Hash of a packed exponent
+	template <class T>
+	auto operator()(const T &exponent) const -> decltype(exponent.template hash<hasher>())
+	{
+		return exponent.template hash<hasher>();
+	}
+};
+
+///	@brief			Prints the statistics of the hashing algorithm on given keys
+///	@tparam	hasher	The hashing algorithm
+///	@tparam	T		The exponent type
+///	@param	name	The name of the algorithm
+///	@param	keys	The distinct keys
+template <class hasher, class T>
+void measure(const std::string &name, const std::vector<T> &keys)
+{
+	const hash_with<hasher> hash;
+	constexpr int repetitions = 20;
+	volatile size_t checksum = 0; //keeps the hashes from being optimized away
+	const auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < repetitions; r++)
+		for (const auto &key : keys)
+			checksum += hash(key);
+	const double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (repetitions * keys.size());
+
+	std::vector<size_t> hashes;
+	hashes.reserve(keys.size());
+	for (const auto &key : keys)
+		hashes.push_back(hash(key));
+	std::sort(hashes.begin(), hashes.end());
+	const size_t collisions = keys.size() - (std::unique(hashes.begin(), hashes.end()) - hashes.begin());
+
+	std::unordered_set<T, hash_with<hasher>> set(keys.begin(), keys.end());
+	size_t probes = 0, longest = 0;
+	for (size_t b = 0; b < set.bucket_count(); b++)
+	{
+		const size_t size = set.bucket_size(b);
+		probes += size * (size + 1) / 2; //the i-th key of a bucket is found after i comparisons
+		longest = std::max(longest, size);
+	}
+
+	size_t slots = 1;
+	while (slots < 2 * keys.size())
+		slots *= 2;
+	std::vector<bool> occupied(slots);
+	for (const auto &key : keys)
+		occupied[hash(key) & (slots - 1)] = 1;
+	const size_t used = std::count(occupied.begin(), occupied.end(), 1);
+	//with uniform hashing, the expected number of occupied slots is slots*(1-(1-1/slots)^keys)
+	const double expected = slots * (1 - std::pow(1 - 1.0 / slots, static_cast<double>(keys.size())));
+
+	std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(2)
+			  << std::setw(10) << nanoseconds << std::setw(12) << collisions
+			  << std::setw(12) << static_cast<double>(probes) / keys.size() << std::setw(10) << longest
+			  << std::setw(14) << static_cast<double>(used) / expected << "\n";
+}
+
+///	@brief		Prints the statistics of all the hashing algorithms on the monomials of the relations for given \f$n\f$
+///	@tparam n	Half the number of variables
+template <size_t n>
+void benchmark()
+{
+	typedef Poly<int64_t, HalfIdempotentVariables<uint8_t, uint16_t>> xy_poly_t;
+	typedef Poly<int64_t, TwistedChernVariables<uint8_t, uint16_t>> chern_poly_t;
+	typedef PackedHalfIdempotentVariables<uint8_t, 2 * n, uint16_t> packed_t;
+	TwistedChernBasis<xy_poly_t, chern_poly_t> tcb(n);
+	std::unordered_set<HalfIdempotentVariables<uint8_t, uint16_t>, hash_with<boost_hash>> distinct;
+	for (const auto &relation : tcb.expand_batch(tcb.relations()))
+		for (auto it = relation.begin(); it != relation.end(); ++it)
+			distinct.insert(it.exponent());
+	for (const auto &generator : tcb.generators())
+		for (auto it = generator.begin(); it != generator.end(); ++it)
+			distinct.insert(it.exponent());
+	const std::vector<HalfIdempotentVariables<uint8_t, uint16_t>> keys(distinct.begin(), distinct.end());
+	std::vector<packed_t> packed;
+	packed.reserve(keys.size());
+	for (const auto &key : keys)
+	{
+		packed_t p;
+		for (size_t i = 0; i < 2 * n; i++)
+			p[i] = key[i];
+		packed.push_back(p);
+	}
+
+	std::cout << "n=" << n << ": " << keys.size() << " distinct monomials in the relations and generators\n";
+	std::cout << "occupancy is the number of occupied slots of a 2^k table (at most half full) over the expected number for uniform hashing\n\n";
+	const auto header = [](const std::string &title) {
+		std::cout << title << "\n"
+				  << std::left << std::setw(12) << "hash" << std::right << std::setw(10) << "ns/hash" << std::setw(12) << "collisions"
+				  << std::setw(12) << "avg probes" << std::setw(10) << "max" << std::setw(14) << "occupancy" << "\n";
+	};
+	header("HalfIdempotentVariables (one byte per variable):");
+	measure<boost_hash>("boost_hash", keys);
+	measure<crc>("crc", keys);
+	measure<wy_hash>("wy_hash", keys);
+	header("\nPackedHalfIdempotentVariables (eight variables per word):");
+	measure<boost_hash>("boost_hash", packed);
+	measure<crc>("crc", packed);
+	measure<wy_hash>("wy_hash", packed);
+}
+
+///	@brief	Runs the benchmark for the \f$n\f$ given as the first argument
+int main(int argc, char **argv)
+{
+	const int n = argc > 1 ? std::atoi(argv[1]) : 5;
+	switch (n)
+	{
+	case 3:
+		benchmark<3>();
+		break;
+	case 4:
+		benchmark<4>();
+		break;
+	case 5:
+		benchmark<5>();
+		break;
+	case 6:
+		benchmark<6>();
+		break;
+	case 7:
+		benchmark<7>();
+		break;
+	case 8:
+		benchmark<8>();
+		break;
+	default:
+		std::cerr << "n must be between 3 and 8\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains the optional instrumentation of the hot paths: counters and timers of the phases of the decompositions
+///	@details	Define \c SYMMP_INSTRUMENT before including any header of this library to enable the instrumentation; otherwise the hooks in the library
+///				expand to nothing and cost nothing. Every thread counts into its own counters (so the workers of a \c TaskPool never contend),
+///				and \ref instrumentation_report adds up the counters of all threads, including those that have exited.
+///
+///				To mark the phases for an external profiler, define \c SYMMP_PROFILE_ZONE(name) before including the library:
+///				it is placed at the start of every phase with its name as a string literal. With \c SYMMP_TRACY it is Tracy's \c ZoneScopedN .
+///				This works with or without \c SYMMP_INSTRUMENT .
+/////////////////////////////////////////////////////////////////////////
+
+#if defined(SYMMP_TRACY) && !defined(SYMMP_PROFILE_ZONE)
+#include <tracy/Tracy.hpp>
+#define SYMMP_PROFILE_ZONE(name) ZoneScopedN(name)
+#endif
+
+#if defined(SYMMP_INSTRUMENT) || defined(SYMMP_PROFILE_ZONE)
+///	@brief	Defined if the phases are timed or marked, so they need a scope of their own
+#define SYMMP_INSTRUMENT_SCOPES
+#endif
+
+#if !defined(SYMMP_PROFILE_ZONE)
+#define SYMMP_PROFILE_ZONE(name)
+#endif
+
+#if defined(SYMMP_INSTRUMENT)
+///	@brief	Adds \p amount to the counter \c InstrumentedCounter::counter of the calling thread (\p amount is not evaluated if the instrumentation is disabled)
+#define SYMMP_INSTRUMENT_COUNT(counter, amount) ::symmp::implementation_details::instrument_count(::symmp::InstrumentedCounter::counter, amount)
+///	@brief	Times the rest of the enclosing scope as the phase \c InstrumentedPhase::phase
+#define SYMMP_INSTRUMENT_PHASE(phase)                                                                     \
+	::symmp::implementation_details::PhaseTimer symmp_phase_##phase(::symmp::InstrumentedPhase::phase); \
+	SYMMP_PROFILE_ZONE(#phase)
+#else
+#define SYMMP_INSTRUMENT_COUNT(counter, amount) ((void)0)
+#define SYMMP_INSTRUMENT_PHASE(phase) SYMMP_PROFILE_ZONE(#phase)
+#endif
+
+#if defined(SYMMP_INSTRUMENT_SCOPES)
+///	@brief	Evaluates an expression as the phase \c InstrumentedPhase::phase
+#define SYMMP_INSTRUMENTED(phase, ...) ([&]() -> decltype(auto) { SYMMP_INSTRUMENT_PHASE(phase); return __VA_ARGS__; }())
+#else
+#define SYMMP_INSTRUMENTED(phase, ...) (__VA_ARGS__)
+#endif
+
+namespace symmp
+{
+	///	@brief	The counters of the instrumentation
+	enum class InstrumentedCounter
+	{
+		decompositions,		  ///<Calls of the decomposition (once per polynomial of \c PolynomialBasis::decompose_batch)
+		expansions,			  ///<Calls of the expansion (once per polynomial of \c PolynomialBasis::expand_batch)
+		reduction_iterations, ///<Leading terms removed by the decompositions
+		product_terms,		  ///<Monomials of the products of generators subtracted by the decompositions
+		cancelled_terms,	  ///<Monomials that cancelled in an addition, subtraction or multiplication of polynomials, in any container
+		rehashes,			  ///<Times a \c MonomialMap or a bucket of a \c GradedContainer moved its entries to a new table
+		peak_monomials		  ///<Sum over the decompositions of the largest number of monomials the remainder had
+	};
+
+	///	@brief	The timed phases of the instrumentation
+	enum class InstrumentedPhase
+	{
+		highest_term,	 ///<Finding the leading term of the remainder of a decomposition
+		find_exponent,	 ///<Finding the product of generators with the same leading term
+		compute_product, ///<Expanding the product of generators (cache lookups included)
+		subtract,		 ///<Subtracting the product from the remainder of a decomposition
+		add				 ///<Adding the product to the result of an expansion
+	};
+
+	constexpr size_t instrumented_counters = 7; ///<The number of values of \ref InstrumentedCounter
+	constexpr size_t instrumented_phases = 5;	///<The number of values of \ref InstrumentedPhase
+
+	///	@brief	The counters and timers of all threads added up
+	///	@note	Phases running on several threads at once add up their times, so the total can exceed the wall time
+	struct InstrumentationReport
+	{
+		std::array<uint64_t, instrumented_counters> counters{};			///<The values of the counters, indexed by \ref InstrumentedCounter
+		std::array<uint64_t, instrumented_phases> phase_calls{};		///<How many times each phase ran, indexed by \ref InstrumentedPhase
+		std::array<uint64_t, instrumented_phases> phase_nanoseconds{};	///<The time spent in each phase, indexed by \ref InstrumentedPhase
+		uint64_t largest_peak_monomials = 0;							///<The largest number of monomials the remainder of a decomposition had
+		size_t threads = 0;												///<The number of threads that have been instrumented
+
+		///	@brief	The value of given counter
+		uint64_t operator[](InstrumentedCounter counter) const;
+
+		///	@brief	The seconds spent in given phase
+		double seconds(InstrumentedPhase phase) const;
+	};
+
+	///	@brief	The name of a counter eg \c "reduction_iterations"
+	const char *instrumentation_name(InstrumentedCounter counter);
+
+	///	@brief	The name of a phase eg \c "compute_product"
+	const char *instrumentation_name(InstrumentedPhase phase);
+
+	///	@brief	Adds up the counters and timers of all threads
+	///	@note	All zero if \c SYMMP_INSTRUMENT is not defined
+	InstrumentationReport instrumentation_report();
+
+	///	@brief		Sets the counters and timers of all threads to zero
+	///	@warning	Counts made during the call may be lost: call it when no computation is running
+	void reset_instrumentation();
+
+	///	@brief	Prints the counters, and the calls, total time and average time of every phase, one per line
+	std::ostream &operator<<(std::ostream &os, const InstrumentationReport &report);
+
+	namespace implementation_details
+	{
+		///The counters and timers of one thread, only written by their thread
+		struct ThreadInstrumentation
+		{
+			std::array<std::atomic<uint64_t>, instrumented_counters> counters;
+			std::array<std::atomic<uint64_t>, instrumented_phases> phase_calls;
+			std::array<std::atomic<uint64_t>, instrumented_phases> phase_nanoseconds;
+			std::atomic<uint64_t> largest_peak_monomials;
+			ThreadInstrumentation();  //registers the thread
+			~ThreadInstrumentation(); //keeps its counts among those of the exited threads
+			void add_to(InstrumentationReport &report) const;
+			void reset();
+		};
+
+		///The instrumentation of the calling thread
+		ThreadInstrumentation &thread_instrumentation();
+
+		///Adds to a counter of the calling thread
+		void instrument_count(InstrumentedCounter counter, uint64_t amount);
+
+		///Records the largest number of monomials the remainder of a decomposition had
+		void instrument_peak(uint64_t monomials);
+
+		///Times its lifetime as a phase
+		class PhaseTimer
+		{
+		public:
+			PhaseTimer(InstrumentedPhase phase);
+			~PhaseTimer();
+
+		private:
+			InstrumentedPhase phase;
+			std::chrono::steady_clock::time_point start;
+		};
+	}
+}
+#include "impl/Instrumentation.ipp"
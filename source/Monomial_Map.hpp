@@ -0,0 +1,196 @@
+#pragma once
+#include "Instrumentation.hpp"
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <functional>
+#include <cstdint>
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains an open addressing hash map used as the unordered monomial container of \c DefaultContainer
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			Open addressing hash map (Robin Hood hashing with linear probing) with the interface of \c std::unordered_map used by \c DefaultContainer
+	///	@details		The key-value pairs are stored inline in a single array of slots, with a parallel array holding the distance of every entry
+	///					from its home slot and a 32 bit fragment of its hash. Lookups stop as soon as they meet an entry closer to its home than
+	///					the probe, and compare the fragment before the key, so the keys (eg exponent vectors) are rarely touched.\n
+	///					Erasing shifts the following entries of the cluster back by one slot, so there are no tombstones and
+	///					repeatedly cancelling monomials never degrades lookups. Iteration is a linear scan of the slots.
+	///	@tparam K		The key type
+	///	@tparam V		The mapped type
+	///	@tparam hash_t	The hash function of \p K
+	///	@tparam equal_t	The equality of \p K
+	///	@tparam alloc_t	The allocator, rebound to the slots (eg \c ArenaAllocator )
+	///	@warning		Unlike \c std::unordered_map every insertion or erasure invalidates all iterators, and the keys are not \c const :
+	///					they must not be modified through an iterator.
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class K, class V, class hash_t = std::hash<K>, class equal_t = std::equal_to<K>, class alloc_t = std::allocator<std::pair<const K, V>>>
+	class MonomialMap
+	{
+		struct Metadata
+		{
+			uint32_t distance; //0 if the slot is empty and 1+(distance from the home slot) otherwise
+			uint32_t fragment; //the high 32 bits of the mixed hash, whose highest bits are the home slot
+		};
+		template <bool is_const>
+		class BasicIterator;
+
+	public:
+		typedef K key_type;				  ///<The key type
+		typedef V mapped_type;			  ///<The mapped type
+		typedef std::pair<K, V> value_type; ///<The stored key-value pair
+		typedef BasicIterator<0> iterator;		///<Iterator through the key-value pairs
+		typedef BasicIterator<1> const_iterator; ///<Constant iterator through the key-value pairs
+
+		///	@brief	Constructs empty map (no allocation)
+		MonomialMap();
+
+		///	@brief	Constructs empty map with given allocator
+		explicit MonomialMap(const alloc_t &alloc);
+
+		///	@brief	Copy constructor: the copy has as many slots as its entries need, and no key is hashed again
+		MonomialMap(const MonomialMap &other);
+
+		///	@brief	Move constructor: steals the table
+		MonomialMap(MonomialMap &&other) noexcept;
+
+		///	@brief	Copy assignment
+		MonomialMap &operator=(const MonomialMap &other);
+
+		///	@brief	Move assignment: steals the table if the allocators allow it, and moves the entries one by one otherwise
+		MonomialMap &operator=(MonomialMap &&other) noexcept(std::allocator_traits<alloc_t>::propagate_on_container_move_assignment::value);
+
+		///	@brief	Destructor
+		~MonomialMap();
+
+		///	@brief	The number of entries
+		size_t size() const;
+
+		///	@brief	Whether there are no entries
+		bool empty() const;
+
+		///	@brief	The number of slots
+		size_t capacity() const;
+
+		///	@brief	The bytes of the table: every slot and its metadata, occupied or not
+		size_t allocated_bytes() const;
+
+		///	@brief		Makes room for given number of entries, so that inserting them does not grow the table
+		///	@param n	The number of entries
+		///	@note		Also shrinks a table that has more than 8 times the slots needed for \p n (or the current entries, if more),
+		///				eg after most entries were erased, since iteration scans every slot
+		void reserve(size_t n);
+
+		///	@brief	Erases all entries, keeping the slots
+		void clear();
+
+		iterator begin();			   ///<Iterator to the first entry
+		iterator end();				   ///<Iterator to just after the final entry
+		const_iterator begin() const; ///<Constant iterator to the first entry
+		const_iterator end() const;   ///<Constant iterator to just after the final entry
+
+		///	@brief		Looks up given key
+		///	@return 	Iterator to the entry with given key, or \ref end if there is none
+		iterator find(const K &key);
+
+		///	@brief		Looks up given key
+		///	@return 	Constant iterator to the entry with given key, or \ref end if there is none
+		const_iterator find(const K &key) const;
+
+		///	@brief			Inserts entry with given key and value, constructed from \p args , if no entry with that key exists
+		///	@param key		The key
+		///	@param args		The arguments of the constructor of the value
+		///	@return			The iterator to the entry with that key and whether it was inserted
+		///	@note			One probe sequence both looks the key up and finds its slot
+		template <class key_arg, class... Args>
+		std::pair<iterator, bool> try_emplace(key_arg &&key, Args &&...args);
+
+		///	@brief	Same as \ref try_emplace
+		template <class key_arg, class... Args>
+		std::pair<iterator, bool> emplace(key_arg &&key, Args &&...args);
+
+		///	@brief		Erases the entry pointed to by given iterator
+		///	@param it	An iterator to an entry (not \ref end)
+		///	@note		The table never shrinks here, so cancelling most entries of a table that was just grown does not rehash it repeatedly;
+		///				see \ref reserve
+		void erase(const_iterator it);
+
+		///	@brief		Erases the entry with given key, if any
+		///	@return		The number of erased entries
+		size_t erase(const K &key);
+
+		///	@brief	Equality of maps: same keys with equal values
+		bool operator==(const MonomialMap &other) const;
+
+		///	@brief	Inequality of maps
+		bool operator!=(const MonomialMap &other) const;
+
+		///	@brief	Returns the allocator
+		alloc_t get_allocator() const;
+
+	private:
+		typedef typename std::allocator_traits<alloc_t>::template rebind_alloc<value_type> slot_alloc_t;
+		typedef typename std::allocator_traits<alloc_t>::template rebind_alloc<Metadata> metadata_alloc_t;
+		typedef std::allocator_traits<slot_alloc_t> slot_traits;
+		typedef std::allocator_traits<metadata_alloc_t> metadata_traits;
+
+		slot_alloc_t slot_alloc;
+		metadata_alloc_t metadata_alloc;
+		value_type *slots;
+		Metadata *metadata;
+		size_t slots_count, entries;
+		uint32_t shift; //32-log2(slots_count): the home slot of a fragment is fragment>>shift
+
+		static uint32_t fragment(size_t hash);
+		size_t home(uint32_t fragment) const;
+		size_t probe(const K &key, uint32_t fragment) const; //the slot holding the key or slots_count
+		size_t place(uint32_t fragment, size_t from, uint32_t distance); //frees the slot a new entry goes into, given where the probe stopped
+		size_t place(uint32_t fragment); //same for an entry known to be absent
+		void rehash(size_t count);
+		void allocate(size_t count);
+		void deallocate();
+		void destroy_entries();
+		void copy_entries(const MonomialMap &other);
+		void steal(MonomialMap &other);
+		static size_t slots_needed(size_t n);
+	};
+
+	///	@brief				Iterator through the entries of a \c MonomialMap
+	///	@tparam is_const	Whether the entries are constant
+	template <class K, class V, class hash_t, class equal_t, class alloc_t>
+	template <bool is_const>
+	class MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator
+	{
+		typedef std::conditional_t<is_const, const MonomialMap, MonomialMap> map_t;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;												///<Iterator category
+		typedef typename MonomialMap::value_type value_type;												///<The key-value pair
+		typedef std::ptrdiff_t difference_type;															///<Difference type
+		typedef std::conditional_t<is_const, const value_type *, value_type *> pointer;						///<Pointer to a key-value pair
+		typedef std::conditional_t<is_const, const value_type &, value_type &> reference;					///<Reference to a key-value pair
+
+		BasicIterator();																	///<Singular iterator
+		template <bool other_const, std::enable_if_t<is_const && !other_const, int> = 0>
+		BasicIterator(const BasicIterator<other_const> &other);								///<Converts iterator to constant iterator
+		reference operator*() const;														///<The current entry
+		pointer operator->() const;															///<Pointer to the current entry
+		BasicIterator &operator++();														///<Moves to the next entry
+		BasicIterator operator++(int);														///<Moves to the next entry, returning the previous position
+		bool operator==(const BasicIterator &other) const;									///<Equality of iterators
+		bool operator!=(const BasicIterator &other) const;									///<Inequality of iterators
+
+	private:
+		BasicIterator(map_t *map, size_t slot);
+		map_t *map;
+		size_t slot;
+		friend class MonomialMap;		 ///<Befriending outer class
+		friend class BasicIterator<!is_const>; ///<Befriending the other constness
+	};
+}
+#include "impl/Monomial_Map.ipp"
@@ -0,0 +1,96 @@
+#pragma once
+#include "Polynomials.hpp"
+#include <array>
+#include <map>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains symmetric polynomials stored as sums of orbits of monomials, with one representative per orbit
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			Polynomial invariant under \f$\Sigma_n\f$, stored as one monomial per orbit: \f$\sum_\lambda c_\lambda m_\lambda\f$ where
+	///					\f$m_\lambda\f$ is the sum of the distinct permutations of the monomial \f$\lambda\f$
+	///	@details		\f$\Sigma_n\f$ permutes the \f$n\f$ columns of the exponents, where column \f$i\f$ consists of the variables \f$i, i+n, ..., i+(blocks-1)n\f$:
+	///					so ```blocks=1``` permutes the \f$x_i\f$ of \c StandardVariables and ```blocks=2``` permutes the pairs \f$(x_i,y_i)\f$ of \c HalfIdempotentVariables .
+	///					The representative of an orbit is its dominant exponent, with the columns in decreasing lexicographic order; this is the largest
+	///					exponent of the orbit, so the highest term of the polynomial is a representative.
+	///
+	///					A product \f$m_\lambda m_\mu\f$ is computed by multiplying \f$\lambda\f$ only by the distinct permutations of \f$\mu\f$
+	///					(or the other way around, whichever orbit is smaller), instead of multiplying both orbits:
+	///					the coefficient of \f$m_\nu\f$ is \f$\frac{|\Sigma_n\lambda|}{|\Sigma_n\nu|}\#\{\beta\in\Sigma_n\mu:\lambda+\beta\in\Sigma_n\nu\}\f$.
+	///					So products and subtractions cost about an orbit size less than on the expanded polynomials, and so does
+	///					the decomposition of \c PolynomialBasis::operator() on an \c OrbitPolynomial .
+	///	@tparam	poly_t	The polynomial type eg ```Poly<int64_t, StandardVariables<int>>```; the representatives are stored as a \p poly_t
+	///	@tparam	blocks	The number of variables in a column
+	///	@warning		The orbit sizes are computed with 64 bit integers, so \f$n\le 20\f$
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class poly_t, size_t blocks = 1>
+	class OrbitPolynomial
+	{
+	public:
+		typedef typename poly_t::scl_t scl_t; ///<The scalar (coefficient) type
+		typedef typename poly_t::exp_t exp_t; ///<The exponent (variable) type
+		typedef typename poly_t::deg_t deg_t; ///<The degree type
+
+		///	@brief				Constructs zero polynomial
+		///	@param	dim_var		Pointer to the dimensions of the variables; used when \c exp_t does not implement method ``` deg_t degree() const ```
+		///	@param	name_var	Pointer to the names of the variables; used when \c exp_t does not implement ``` std::string  static name(int,int)```
+		OrbitPolynomial(const deg_t *dim_var = nullptr, const std::string *name_var = nullptr);
+
+		///	@brief				Compresses a symmetric polynomial
+		///	@param	a			The polynomial
+		///	@param	dim_var		Pointer to the dimensions of the variables; used when \c exp_t does not implement method ``` deg_t degree() const ```
+		///	@param	name_var	Pointer to the names of the variables; used when \c exp_t does not implement ``` std::string  static name(int,int)```
+		///	@warning			Only the monomials of \p a with dominant exponents are read: it's the user's responsibility to make sure \p a is symmetric
+		explicit OrbitPolynomial(const poly_t &a, const deg_t *dim_var = nullptr, const std::string *name_var = nullptr);
+
+		///	@brief	The polynomial with every orbit expanded
+		poly_t expand() const;
+
+		///	@brief	The representatives of the orbits with their coefficients
+		const poly_t &representatives() const;
+
+		///	@brief	The number of orbits
+		size_t number_of_monomials() const;
+
+		///	@brief	The number of monomials of the expanded polynomial
+		uint64_t number_of_expanded_monomials() const;
+
+		///	@brief		The leading representative: of the highest degree and then the largest exponent, as in the decompositions of \c PolynomialBasis
+		///	@return		The exponent and the coefficient
+		///	@warning	May only be used on nonzero polynomials
+		std::pair<exp_t, scl_t> highest_term() const;
+
+		OrbitPolynomial &operator+=(const OrbitPolynomial &other);		///<Addition assignment
+		OrbitPolynomial &operator-=(const OrbitPolynomial &other);		///<Subtraction assignment
+		OrbitPolynomial &operator*=(const OrbitPolynomial &other);		///<Multiplication assignment
+		OrbitPolynomial &operator*=(scl_t scalar);						///<Scalar multiplication assignment
+		OrbitPolynomial operator+(const OrbitPolynomial &other) const;	///<Addition
+		OrbitPolynomial operator-(const OrbitPolynomial &other) const;	///<Subtraction
+		OrbitPolynomial operator*(const OrbitPolynomial &other) const;	///<Multiplication, without expanding the orbits
+		bool operator==(const OrbitPolynomial &other) const;			///<Equality
+		bool operator!=(const OrbitPolynomial &other) const;			///<Inequality
+
+		///	@brief	The dominant exponent of the orbit of an exponent (the columns sorted in decreasing order)
+		static exp_t canonical(const exp_t &exponent);
+
+		///	@brief	The number of distinct permutations of an exponent
+		static uint64_t orbit_size(const exp_t &exponent);
+
+	private:
+		typedef std::array<typename exp_t::value_type, blocks> column_t;
+		poly_t monomials;
+		const deg_t *dim_var;
+		const std::string *name_var;
+		static std::vector<column_t> columns(const exp_t &exponent);
+		static void set_columns(exp_t &exponent, const std::vector<column_t> &columns);
+		template <class fun>
+		static void for_each_permutation(const exp_t &exponent, const fun &receive);
+	};
+}
+#include "impl/Orbit_Polynomials.ipp"
@@ -0,0 +1,199 @@
+#pragma once
+#include "Half_Idempotent.hpp"
+#include <initializer_list>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains variable types whose exponents are packed into a few machine words
+///	@details	Each exponent is stored in a lane of 8 or 16 bits and the lanes are packed into \c uint64_t words,
+///				so an exponent never allocates and addition, subtraction, divisibility, comparison and hashing
+///				act on whole words at a time (SIMD within a register). The graded variable types also keep their degree
+///				inside the packed exponent, so the monomial containers use the exponent itself as the key.
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			Fixed length exponent with unsigned 8 or 16 bit lanes packed into \c uint64_t words
+	///	@details		Lane \f$i\f$ is stored in word \f$i/L\f$ (\f$L\f$ lanes per word) starting from the most significant bits,
+	///					so comparing the words as integers compares the exponents lexicographically.\n
+	///					The degree \f$\sum_iw_ia_i\f$ is updated on every write, with the weights \f$w_i\f$ provided by the child class.
+	///	@tparam spec_t	Used for compile-time polymorphism (CRTP): must be the child class. It must provide
+	///					``` static constexpr _deg weight(size_t) ``` and ``` static constexpr size_t idempotent_start ```
+	///					(every lane from \c idempotent_start on is idempotent: its exponent is 0 or 1 and its weight is 0).
+	///	@tparam T		The value type of each lane: \c uint8_t or \c uint16_t
+	///	@tparam N		The number of variables
+	///	@tparam _deg	The (integral) value type used in the degree function.
+	///	@warning		Lanes wrap around on overflow; it is the user's responsibility to pick \c T large enough for the exponents involved.
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class spec_t, class T, size_t N, class _deg>
+	class PackedExponent
+	{
+		static_assert(std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>, "Packed exponents have 8 or 16 bit lanes");
+		static constexpr size_t bits = 8 * sizeof(T);
+		static constexpr size_t lanes = 64 / bits;
+		static constexpr size_t words = (N + lanes - 1) / lanes;
+
+	public:
+		typedef T value_type; ///<Value type of each lane
+		typedef _deg deg_t;	  ///<Degree typedef
+
+		/// @brief	Proxy reference to a lane, keeping the degree in sync on every write
+		class reference
+		{
+		public:
+			operator T() const;						///<Value of the lane
+			reference &operator=(T value);			///<Sets the lane
+			reference &operator=(const reference &); ///<Sets the lane to the value of the other lane
+			reference &operator+=(T value);			///<Adds to the lane
+			reference &operator-=(T value);			///<Subtracts from the lane
+			reference &operator++();				///<Increments the lane
+			T operator++(int);						///<Increments the lane, returning its previous value
+		private:
+			reference(PackedExponent &, size_t);
+			PackedExponent &exponent;
+			const size_t i;
+			friend class PackedExponent; ///<Befriending outer class
+		};
+
+		///	@brief	Constructs the zero exponent
+		PackedExponent();
+
+		///	@brief	Constructor with "size" constructs the zero exponent (used to have consistent interface with vector)
+		PackedExponent(size_t);
+
+		///	@brief			Constructs exponent with given values
+		///	@param 	values	The exponents \f$[a_1,...,a_k]\f$, \f$k\le N\f$; the rest are 0
+		PackedExponent(std::initializer_list<T> values);
+
+		///	@brief	The number of variables
+		static constexpr size_t size();
+
+		static constexpr size_t static_size = N; ///<The number of variables, known in compile-time
+
+		///	@brief	The exponent of the \p i -th variable
+		T operator[](size_t i) const;
+
+		///	@brief	Reference to the exponent of the \p i -th variable
+		reference operator[](size_t i);
+
+		///	@brief		Multiplies monomials by adding their exponents
+		///	@param 	b 	The exponent \f$[b_1,...,b_N]\f$ we add to ```*this```=\f$[a_1,...,a_N]\f$
+		///	@return 	\f$[a_1+b_1,...]\f$ on the ordinary lanes and \f$\max(a_i,b_i)\f$ on the idempotent lanes
+		spec_t operator+(const spec_t &b) const;
+
+		///	@brief		Multiplies monomials in place by adding their exponents
+		///	@param 	b 	The exponent \f$[b_1,...,b_N]\f$ we add to ```*this```=\f$[a_1,...,a_N]\f$
+		///	@return 	Reference to ```*this```
+		spec_t &operator+=(const spec_t &b);
+
+		///	@brief		Divides monomials by subtracting their exponents
+		///	@param 	b 	The exponent \f$[b_1,...,b_N]\f$ we subtract from ```*this```=\f$[a_1,...,a_N]\f$
+		///	@warning	We must have \f$b_i\le a_i\f$ for every \f$i\f$.
+		///	@return 	\f$[a_1-b_1,...]\f$ on the ordinary lanes and \f$|a_i-b_i|\f$ on the idempotent lanes
+		spec_t operator-(const spec_t &b) const;
+
+		///	@brief		Dominance test (divisibility of monomials)
+		///	@param 	b 	The exponent \f$[b_1,...,b_N]\f$
+		///	@return 	Whether \f$a_i\le b_i\f$ for every \f$i\f$ where ```*this```=\f$[a_1,...,a_N]\f$
+		bool divides(const spec_t &b) const;
+
+		///	@brief	Equality of exponents
+		bool operator==(const PackedExponent &b) const;
+
+		///	@brief	Inequality of exponents
+		bool operator!=(const PackedExponent &b) const;
+
+		///	@brief	Compares degrees first and then the exponents lexicographically (same order as a degree+exponent pair)
+		bool operator<(const PackedExponent &b) const;
+
+		/// @brief	Hashes monomial
+		/// @return Hash of the packed words (calls \ref generic_hasher with \c wy_hash , one multiplication per word)
+		size_t operator()() const;
+
+		/// @brief			Hashes monomial with given algorithm
+		///	@tparam	hasher	The hashing algorithm eg \c crc or \c boost_hash
+		/// @return 		Hash of the packed words
+		template <class hasher>
+		size_t hash() const;
+
+	protected:
+		std::array<uint64_t, words> data; ///<The packed lanes
+		deg_t deg;						  ///<The degree, kept in sync with the lanes
+
+	private:
+		static constexpr uint64_t lane_mask = (uint64_t(1) << bits) - 1;
+		static constexpr size_t shift(size_t i);
+		static constexpr std::array<uint64_t, words> make_high_mask();
+		static constexpr std::array<uint64_t, words> make_idempotent_mask();
+		static constexpr std::array<uint64_t, words> high_mask = make_high_mask();
+		static constexpr std::array<uint64_t, words> idempotent_mask = make_idempotent_mask();
+		void set(size_t i, T value);
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief 				Packed version of \c StandardVariables: variables \f$x_1,...,x_N\f$ with \f$|x_i|=1\f$ and no relations.
+	///	@tparam		T 		The value type of each lane: \c uint8_t or \c uint16_t
+	///	@tparam		N 		The number of variables
+	///	@tparam		_deg	The (integral) value type used in the degree function.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class T, size_t N, class _deg = int64_t>
+	struct PackedStandardVariables : public PackedExponent<PackedStandardVariables<T, N, _deg>, T, N, _deg>
+	{
+		using PackedExponent<PackedStandardVariables<T, N, _deg>, T, N, _deg>::PackedExponent;
+		static constexpr bool stores_degree = 1;  ///<The degree is stored in the exponent
+		static constexpr size_t idempotent_start = N; ///<No idempotent variables
+
+		///	@brief	Every variable has degree 1
+		static constexpr _deg weight(size_t);
+
+		///	@brief	The stored degree \f$\sum_ia_i\f$
+		_deg degree() const;
+
+		///	@brief		Returns the names of the standard variables \f$x_i\f$
+		///	@return  	\c "x_i"
+		static std::string name(int i, int n);
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			Packed version of \c HalfIdempotentVariables: variables \f$x_1,...,x_n,y_1,...,y_n\f$ with \f$y_i^2=y_i\f$ and \f$|x_i|=1\f$, \f$|y_i|=0\f$
+	///	@tparam T 		The value type of each lane: \c uint8_t or \c uint16_t
+	///	@tparam N 		The number of variables \f$2n\f$
+	///	@tparam _deg	The (integral) value type used in the degree function.
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class T, size_t N, class _deg = int64_t>
+	struct PackedHalfIdempotentVariables : public PackedExponent<PackedHalfIdempotentVariables<T, N, _deg>, T, N, _deg>
+	{
+		using PackedExponent<PackedHalfIdempotentVariables<T, N, _deg>, T, N, _deg>::PackedExponent;
+		static constexpr bool stores_degree = 1;		  ///<The degree is stored in the exponent
+		static constexpr size_t idempotent_start = N / 2; ///<The \f$y_i\f$ are idempotent
+
+		///	@brief	\f$|x_i|=1\f$ and \f$|y_i|=0\f$
+		static constexpr _deg weight(size_t i);
+
+		///	@brief	The stored degree \f$\sum_{i=1}^na_i\f$
+		_deg degree() const;
+
+		///	@brief	Returns the names of the variables \f$x_i,y_i\f$ (same as \c HalfIdempotentVariables)
+		static std::string name(int i, int num);
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			Packed version of \c TwistedChernVariables
+	///	@note			As in \c TwistedChernVariables, degrees and names are provided as pointers by \c TwistedChernBasis, so the degree is kept in the key instead
+	///	@tparam T 		The value type of each lane: \c uint8_t or \c uint16_t
+	///	@tparam N 		The number of generators \f$n+n(n+1)/2\f$
+	///	@tparam _deg	The (integral) value type used in the degree function.
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class T, size_t N, class _deg = int64_t>
+	struct PackedTwistedChernVariables : public PackedExponent<PackedTwistedChernVariables<T, N, _deg>, T, N, _deg>
+	{
+		using PackedExponent<PackedTwistedChernVariables<T, N, _deg>, T, N, _deg>::PackedExponent;
+		static constexpr size_t idempotent_start = N; ///<No idempotent variables
+
+		///	@brief	The grading is not known to the exponent
+		static constexpr _deg weight(size_t);
+	};
+}
+#include "impl/Packed_Variables.ipp"
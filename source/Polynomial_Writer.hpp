@@ -0,0 +1,115 @@
+#pragma once
+#include "Polynomials.hpp"
+#include <charconv>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+///	@brief	Defined if \c PolynomialWriter can write directly to a file descriptor
+#define SYMMP_WRITE_DESCRIPTOR
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains a buffered writer that formats polynomials much faster than \c operator<< on an \c std::ostream
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief		Formats text and polynomials into a reusable buffer that is written out in large chunks
+	///	@details	Polynomials are printed exactly as by \c operator<< (and the zero polynomial as \c 0 ), but integers are formatted with \c std::to_chars
+	///				and the names of the variables are built once per exponent type and number of variables, instead of once per monomial.
+	///				So printing many polynomials, eg the relations of \c TwistedChernBasis , allocates nothing after the first few and
+	///				touches the underlying stream or file only once per chunk.
+	///	@note		Scalars that are not integers (eg \c double or \c ModularInteger ) are formatted with their \c operator<<
+	///	@warning	Not thread-safe: use one writer per thread, or a mutex
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class PolynomialWriter
+	{
+	public:
+		static constexpr size_t default_chunk = size_t(1) << 16; ///<The default number of bytes buffered before writing out
+
+		///	@brief			Writes to an output stream eg \c std::cout
+		///	@param os		The output stream, which must outlive the writer
+		///	@param chunk	The number of bytes buffered before writing out
+		PolynomialWriter(std::ostream &os, size_t chunk = default_chunk);
+
+		///	@brief			Writes to a file
+		///	@param path		The path of the file (overwritten)
+		///	@param chunk	The number of bytes buffered before writing out
+		///	@note			Check \ref good to see whether the file could be opened
+		PolynomialWriter(const std::string &path, size_t chunk = default_chunk);
+
+#if defined(SYMMP_WRITE_DESCRIPTOR)
+		///	@brief				Writes to a file descriptor eg \c STDOUT_FILENO , bypassing the buffers of the C++ streams
+		///	@param descriptor	The file descriptor, which is not closed by the writer
+		///	@param chunk		The number of bytes buffered before writing out
+		///	@attention			Flush \c std::cout before writing to its descriptor, and flush the writer before using \c std::cout again
+		PolynomialWriter(int descriptor, size_t chunk = default_chunk);
+#endif
+
+		///	@brief	Writes out everything left in the buffer
+		~PolynomialWriter();
+
+		PolynomialWriter(const PolynomialWriter &) = delete;
+		PolynomialWriter &operator=(const PolynomialWriter &) = delete;
+
+		///	@brief	Writes out the buffer
+		void flush();
+
+		///	@brief	Whether all output so far has been written successfully
+		bool good() const;
+
+		///	@brief			Appends bytes
+		///	@param data		Pointer to the bytes
+		///	@param size		The number of bytes
+		///	@return			Reference to \c *this
+		PolynomialWriter &write(const char *data, size_t size);
+
+		PolynomialWriter &operator<<(std::string_view text); ///<Appends text
+		PolynomialWriter &operator<<(char c);				 ///<Appends character
+
+		///	@brief		Appends integer in decimal (characters are appended as characters, see the other overload)
+		///	@tparam T	Any integer type eg \c int or \c uint8_t
+		template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+		PolynomialWriter &operator<<(T value);
+
+		///	@brief				Appends polynomial, formatted like \c operator<<
+		///	@tparam container_t	The data storage type of the polynomial eg \c DefaultContainer
+		template <class container_t>
+		PolynomialWriter &operator<<(const Polynomial<container_t> &a);
+
+	private:
+		typedef std::string (*name_function_t)(int, int);
+		struct Names
+		{
+			name_function_t function;
+			int number_of_variables;
+			std::vector<std::string> names;
+		};
+		std::ostream *stream;
+		std::unique_ptr<std::ofstream> file;
+		int descriptor;
+		size_t chunk;
+		bool ok;
+		std::string buffer;
+		std::vector<Names> cached_names;
+		std::ostringstream fallback; //formats scalars without std::to_chars
+		void write_out();
+		const std::vector<std::string> &names(name_function_t function, int number_of_variables);
+		template <class scl_t>
+		void write_scalar(const scl_t &coeff);
+		template <class scl_t, class exp_t, class fun>
+		void write_monomial(const scl_t &coeff, const exp_t &exponent, const fun &variable_name);
+	};
+}
+#include "impl/Polynomial_Writer.ipp"
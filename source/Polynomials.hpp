@@ -1,8 +1,12 @@
 #pragma once
 #include "General.hpp"
 #include "impl/Details.ipp"
+#include "Monomial_Map.hpp"
 #include <map>
 #include <unordered_map>
+#include <vector>
+#include <optional>
+#include <algorithm>
 #include <string>
 #include <iostream>
 
@@ -11,6 +15,28 @@
 
 namespace symmp
 {
+	class PolynomialWriter;
+
+	///	@brief		Estimated memory footprint of a polynomial, in bytes (see \c Polynomial::memory_usage )
+	///	@details	The sizes of the nodes of the standard maps are those of the common implementations, and the heap storage of the exponents
+	///				(if they are vectors) is that of one monomial times the number of monomials, as all exponents have the same length.
+	struct MemoryUsage
+	{
+		size_t monomials = 0; ///<The bytes of the monomials themselves: keys (with the heap storage of their exponents) and coefficients
+		size_t overhead = 0;  ///<The bytes of the container around them: links, buckets, unused slots or capacity, and the object itself
+
+		///	@brief	All bytes
+		size_t total() const { return monomials + overhead; }
+
+		///	@brief	Adds the bytes of another polynomial
+		MemoryUsage &operator+=(const MemoryUsage &other)
+		{
+			monomials += other.monomials;
+			overhead += other.overhead;
+			return *this;
+		}
+	};
+
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	/// @brief			The base of all monomial containers
 	/// @tparam	 exp_t	The variable/exponent type of the monomials
@@ -45,7 +71,8 @@ namespace symmp
 	///	@brief				The default ordered/unordered monomial container
 	/// @details			Monomials are stored as key-value pairs where each key consists of degree+exponent and 
 	///						the value is the coefficient of the monomial.
-	///	@note				We store the degree for improved performance.
+	///	@note				We store the degree for improved performance. If \c exp_t already stores its own degree
+	///						(eg \c PackedStandardVariables) then the key is just the exponent.
 	/// @tparam _scl		The scalar/coefficient type of the monomials eg \c float or \c int64_t
 	/// @tparam _exp		The variable/exponent type of the monomials eg \c StandardVariables or \c HalfIdempotentVariables
 	/// @tparam _cnt		The underlying container: this should be equivalent to \c std::map if \c _ord==1 and \c std::unordered_map otherwise
@@ -65,6 +92,7 @@ namespace symmp
 		typedef _scl scl_t;					///<The scalar (coefficient) type eg \c int64_t
 		typedef _exp exp_t;					///<The exponent (variable) type eg \c StandardVariables or \c HalfIdempotentVariables
 		typedef typename _exp::deg_t deg_t;	///<The degree type eg \c size_t
+		typedef implementation_details::pair_t<_exp> key_t;	///<The monomial key: degree+exponent, or just the exponent if it stores its degree
 	public:
 		/// @brief	Returns number of monomials in the polynomial
 		size_t number_of_monomials() const;
@@ -87,6 +115,16 @@ namespace symmp
 		///					the exponent being inserted is not already there and that \c coeff is not 0
 		void insert(const exp_t& exp, scl_t coeff);
 
+		/// @brief			Inserts a range of monomials sorted in increasing order
+		///	@tparam	iter_t	A forward iterator to pairs of exponent and coefficient
+		///	@param	first	The first monomial
+		///	@param	last	Just after the final monomial
+		/// @note			If ```_ord==1``` every monomial is placed with the end of the map as hint, so no comparisons or searches are needed;
+		///					otherwise the map is reserved for the whole range in advance.
+		/// @warning		Same as \ref insert for each monomial
+		template <class iter_t>
+		void insert_sorted(iter_t first, iter_t last);
+
 		/// @brief Constant iterator traversing the monomials of a polynomial
 		class ConstIterator : public data_t::const_iterator {
 		public:
@@ -105,6 +143,18 @@ namespace symmp
 		///			Otherwise it finds the highest degree by linear search through the entire polynomial in \f$O(n)\f$ time.
 		ConstIterator highest_term() const;
 
+		/// @brief	Estimated bytes of the monomials and of the container
+		///	@note	\f$O(1)\f$: an ordered map has one node of three links and a colour per monomial; an unordered map reports its table
+		MemoryUsage memory_usage() const;
+
+		/// @brief	Number of monomial additions on the calling thread that found the monomial already present, so no node was allocated
+		/// @note	Counted by \c add, \c subtract and \c multiply_add across all containers of this type; reset with \ref reset_allocations_avoided .
+		///			Only counted if \c SYMMP_INSTRUMENT is defined (see Instrumentation.hpp), so that the additions cost nothing extra otherwise; always 0 if not
+		static size_t allocations_avoided();
+
+		/// @brief	Resets the counter \ref allocations_avoided of the calling thread
+		static void reset_allocations_avoided();
+
 	protected:
 		using BaseContainer<exp_t>::BaseContainer;
 		/// @brief Non const iterator traversing the monomials of a polynomial
@@ -121,21 +171,368 @@ namespace symmp
 
 		/// @brief		Adds given monomial to polynomial
 		/// @param kvp	The key-value pair representing the monomial
-		void add(const std::pair<const std::pair<deg_t, exp_t>, scl_t>& kvp);
+		void add(const typename data_t::value_type& kvp);
+
+		/// @brief		Subtracts given monomial from polynomial
+		/// @param kvp	The key-value pair representing the monomial
+		void subtract(const typename data_t::value_type& kvp);
+
+		/// @brief		Multiplies the two given monomials and then adds the product to polynomial
+		/// @param kvp1	The key-value pair representing the first monomial
+		/// @param kvp2	The key-value pair representing the second monomial
+		void multiply_add(const typename data_t::value_type& kvp1, const typename data_t::value_type& kvp2);
+
+		/// @brief		Adds given polynomial to polynomial
+		/// @param b	The container of the polynomial we add
+		void add(const DefaultContainer& b);
+
+		/// @brief		Subtracts given polynomial from polynomial
+		/// @param b	The container of the polynomial we subtract
+		void subtract(const DefaultContainer& b);
+
+		/// @brief		Multiplies the two given polynomials and then adds the product to polynomial
+		/// @param a	The container of the first polynomial
+		/// @param b	The container of the second polynomial
+		/// @note		The product of each pair of monomials is written in a reused scratch key and a node is only allocated if it is a new monomial
+		void multiply_add(const DefaultContainer& a, const DefaultContainer& b);
+
+		/// @brief				Multiplies the two given polynomials and then adds the terms of the product up to given degree to polynomial
+		/// @param a			The container of the first polynomial
+		/// @param b			The container of the second polynomial
+		/// @param max_degree	The highest degree of the terms kept
+		/// @note				The monomials are visited in increasing degree, so the pairs of degree above \p max_degree are never multiplied
+		void multiply_add(const DefaultContainer& a, const DefaultContainer& b, deg_t max_degree);
+
+		/// @brief		Multiplies every monomial of polynomial by the given monomial, in place
+		/// @param key	The key of the monomial
+		/// @note		The ordered map keeps its nodes, which are re-keyed and relinked; the unordered map is rebuilt in one allocation.
+		///				Monomials with the same product (eg if \c exp_t has idempotent variables like \c HalfIdempotentVariables ) are combined
+		void multiply_monomial(const key_t& key);
+	private:
+		void add(const key_t& key, scl_t value);
+		static size_t& avoided_counter();
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief				Contiguous monomial container: a \c std::vector of monomials sorted by degree+exponent
+	/// @details			Monomials are stored as in \c DefaultContainer with ```_ord==1```, but in a single contiguous allocation
+	///						instead of one heap node per monomial. Polynomial addition/subtraction is a linear merge of two sorted ranges
+	///						and multiplication sorts and combines the products in bounded chunks before merging them in.
+	/// @tparam _scl		The scalar/coefficient type of the monomials eg \c float or \c int64_t
+	/// @tparam _exp		The variable/exponent type of the monomials eg \c StandardVariables or \c HalfIdempotentVariables
+	/// @tparam _arg		Any extra optional arguments to pass to \c std::vector apart from the value type eg an allocator
+	///	@attention			In addition to the requirements from BaseContainer, \c exp_t needs to have a comparator ``` bool operator<(const _exp&)  const ```
+	///	@warning			Inserting or adding a single monomial is \f$O(n)\f$ as later monomials have to be shifted;
+	///						prefer combining whole polynomials via \c +=, \c -=, \c *
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class _scl, class _exp, class ... _arg>
+	class FlatContainer : public BaseContainer<_exp>, std::vector<std::pair<implementation_details::pair_t<_exp>, _scl>, _arg...> {
+	private:
+		typedef std::vector<std::pair<implementation_details::pair_t<_exp>, _scl>, _arg...> data_t;
+	protected:
+		typedef _scl scl_t;					///<The scalar (coefficient) type eg \c int64_t
+		typedef _exp exp_t;					///<The exponent (variable) type eg \c StandardVariables or \c HalfIdempotentVariables
+		typedef typename _exp::deg_t deg_t;	///<The degree type eg \c size_t
+		typedef implementation_details::pair_t<_exp> key_t;	///<The monomial key: degree+exponent, or just the exponent if it stores its degree
+	public:
+		/// @brief	Returns number of monomials in the polynomial
+		size_t number_of_monomials() const;
+
+		/// @brief Equality of polynomials
+		bool operator==(const FlatContainer&) const;
+
+		/// @brief Inequality of polynomials
+		bool operator!=(const FlatContainer& b) const;
+
+		/// @brief			Reserve number of monomials in polynomial
+		///	@param		n	Number to reserve
+		void reserve(size_t n);
+
+		/// @brief			Inserts monomial in polynomial.
+		///	@param	exp		The exponent of the monomial.
+		///	@param	coeff	The coefficient of the monomial.
+		/// @warning		It is the user's responsibility to make sure that all exponents have the same length(number of variables),
+		///					the exponent being inserted is not already there and that \c coeff is not 0
+		/// @note			\f$O(1)\f$ if the monomial is higher than all existing ones, \f$O(n)\f$ otherwise
+		void insert(const exp_t& exp, scl_t coeff);
+
+		/// @brief			Inserts a range of monomials sorted in increasing order
+		///	@tparam	iter_t	A forward iterator to pairs of exponent and coefficient
+		///	@param	first	The first monomial
+		///	@param	last	Just after the final monomial
+		/// @note			The range is appended in a single allocation and merged in place with the existing monomials, if any
+		/// @warning		Same as \ref insert for each monomial
+		template <class iter_t>
+		void insert_sorted(iter_t first, iter_t last);
+
+		/// @brief Constant iterator traversing the monomials of a polynomial
+		class ConstIterator : public data_t::const_iterator {
+		public:
+			scl_t coeff() const;			///<The coefficient of the monomial
+			const exp_t& exponent() const;	///<The exponent of the monomial
+			deg_t degree() const;			///<The degree of the monomial
+		private:
+			ConstIterator(typename data_t::const_iterator);
+			friend class FlatContainer; ///<Befriending outer class
+		};
+		ConstIterator begin() const;	///<ConstIterator to the first monomial
+		ConstIterator end() const;		///<ConstIterator to just after the final monomial
+
+		/// @brief	ConstIterator to the highest term monomial
+		///	@note	This is the last monomial so it takes \f$O(1)\f$ time.
+		ConstIterator highest_term() const;
+
+		/// @brief	Estimated bytes of the monomials and of the container
+		///	@note	\f$O(1)\f$: the overhead is the unused capacity of the vector
+		MemoryUsage memory_usage() const;
+
+	protected:
+		using BaseContainer<exp_t>::BaseContainer;
+		/// @brief Non const iterator traversing the monomials of a polynomial
+		class Iterator : public data_t::iterator {
+		public:
+			scl_t& coeff();	///<Reference to the coefficient of the monomial
+		private:
+			Iterator(typename data_t::iterator);
+			friend class FlatContainer; ///<Befriending outer class
+		};
+
+		Iterator begin();	///<Iterator to the first monomial
+		Iterator end();		///<Iterator to just after the final monomial
+
+		/// @brief		Adds given monomial to polynomial
+		/// @param kvp	The key-value pair representing the monomial
+		void add(const typename data_t::value_type& kvp);
+
+		/// @brief		Subtracts given monomial from polynomial
+		/// @param kvp	The key-value pair representing the monomial
+		void subtract(const typename data_t::value_type& kvp);
+
+		/// @brief		Multiplies the two given monomials and then adds the product to polynomial
+		/// @param kvp1	The key-value pair representing the first monomial
+		/// @param kvp2	The key-value pair representing the second monomial
+		void multiply_add(const typename data_t::value_type& kvp1, const typename data_t::value_type& kvp2);
+
+		/// @brief		Adds given polynomial to polynomial by merging the two sorted ranges
+		/// @param b	The container of the polynomial we add
+		void add(const FlatContainer& b);
+
+		/// @brief		Subtracts given polynomial from polynomial by merging the two sorted ranges
+		/// @param b	The container of the polynomial we subtract
+		void subtract(const FlatContainer& b);
+
+		/// @brief		Multiplies the two given polynomials and then adds the product to polynomial
+		/// @param a	The container of the first polynomial
+		/// @param b	The container of the second polynomial
+		void multiply_add(const FlatContainer& a, const FlatContainer& b);
+
+		/// @brief				Multiplies the two given polynomials and then adds the terms of the product up to given degree to polynomial
+		/// @param a			The container of the first polynomial
+		/// @param b			The container of the second polynomial
+		/// @param max_degree	The highest degree of the terms kept
+		/// @note				The monomials are visited in increasing degree, so the pairs of degree above \p max_degree are never multiplied
+		void multiply_add(const FlatContainer& a, const FlatContainer& b, deg_t max_degree);
+
+		/// @brief		Multiplies every monomial of polynomial by the given monomial, in place
+		/// @param key	The key of the monomial
+		/// @note		The keys are overwritten in place. Their order is checked: it's preserved unless \c exp_t has idempotent variables
+		///				(eg \c HalfIdempotentVariables ), in which case they are sorted again and the monomials with the same product are combined
+		void multiply_monomial(const key_t& key);
+	private:
+		void add(const key_t& key, scl_t value);
+		template <bool negate>
+		void merge(const data_t& b);
+		void combine(data_t& chunk); //sorts the products, combines equal monomials and merges them into *this, leaving chunk empty
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief				Graded monomial container: a \c std::map from each degree to a \c std::unordered_map of the monomials of that degree
+	/// @details			Since the buckets are sorted by degree, the highest term is found by searching only the monomials of the top degree
+	///						and multiplication pairs the buckets by degree, so every product of a pair of buckets goes to a single known bucket.
+	///						Homogeneous components can also be moved out without copying (see \ref extract_components).
+	/// @tparam _scl		The scalar/coefficient type of the monomials eg \c float or \c int64_t
+	/// @tparam _exp		The variable/exponent type of the monomials eg \c StandardVariables or \c HalfIdempotentVariables
+	/// @tparam _arg		Any extra optional arguments to pass to each \c std::unordered_map bucket apart from key,value, hash eg an allocator
+	///	@attention			The requirements from \c exp_t are those of \c DefaultContainer with ```_ord==0```
+	///	@note				Empty buckets are never kept, so the number of buckets is the number of distinct degrees
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class _scl, class _exp, class ... _arg>
+	class GradedContainer : public BaseContainer<_exp>, std::map<typename _exp::deg_t, implementation_details::container_wrapper<_scl, _exp, std::unordered_map, 0, _arg...>> {
+	private:
+		typedef implementation_details::container_wrapper<_scl, _exp, std::unordered_map, 0, _arg...> bucket_t;
+		typedef std::map<typename _exp::deg_t, bucket_t> data_t;
+	protected:
+		typedef _scl scl_t;					///<The scalar (coefficient) type eg \c int64_t
+		typedef _exp exp_t;					///<The exponent (variable) type eg \c StandardVariables or \c HalfIdempotentVariables
+		typedef typename _exp::deg_t deg_t;	///<The degree type eg \c size_t
+		typedef implementation_details::pair_t<_exp> key_t;	///<The monomial key: degree+exponent, or just the exponent if it stores its degree
+	public:
+		///	@brief	Used to detect graded containers
+		static constexpr bool graded = 1;
+
+		GradedContainer(const GradedContainer&) = default;				///<Copy constructor
+		GradedContainer& operator=(const GradedContainer&) = default;	///<Copy assignment
+
+		///	@brief	Move constructor; the source is left empty, so that its number of monomials is 0 like its buckets
+		GradedContainer(GradedContainer&& other) noexcept;
+
+		///	@brief	Move assignment; the source is left empty, so that its number of monomials is 0 like its buckets
+		GradedContainer& operator=(GradedContainer&& other) noexcept;
+
+		/// @brief	Returns number of monomials in the polynomial
+		size_t number_of_monomials() const;
+
+		/// @brief Equality of polynomials
+		bool operator==(const GradedContainer&) const;
+
+		/// @brief Inequality of polynomials
+		bool operator!=(const GradedContainer& b) const;
+
+		/// @brief			Reserve number of monomials in polynomial
+		///	@param		n	Number to reserve
+		/// @attention		Does nothing, as the degrees of the monomials are not known in advance
+		void reserve(size_t n);
+
+		/// @brief			Inserts monomial in polynomial.
+		///	@param	exp		The exponent of the monomial.
+		///	@param	coeff	The coefficient of the monomial.
+		/// @warning		It is the user's responsibility to make sure that all exponents have the same length(number of variables),
+		///					the exponent being inserted is not already there and that \c coeff is not 0
+		void insert(const exp_t& exp, scl_t coeff);
+
+		/// @brief			Inserts a range of monomials sorted in increasing order
+		///	@tparam	iter_t	A forward iterator to pairs of exponent and coefficient
+		///	@param	first	The first monomial
+		///	@param	last	Just after the final monomial
+		/// @note			The monomials of each degree are consecutive, so each bucket is looked up and reserved once
+		/// @warning		Same as \ref insert for each monomial
+		template <class iter_t>
+		void insert_sorted(iter_t first, iter_t last);
+
+		/// @brief Constant iterator traversing the monomials of a polynomial, in increasing degree
+		class ConstIterator {
+		public:
+			scl_t coeff() const;			///<The coefficient of the monomial
+			const exp_t& exponent() const;	///<The exponent of the monomial
+			deg_t degree() const;			///<The degree of the monomial
+			const typename bucket_t::value_type& operator*() const;	///<The key-value pair of the monomial
+			const typename bucket_t::value_type* operator->() const;	///<The key-value pair of the monomial
+			ConstIterator& operator++();							///<Moves to the next monomial
+			bool operator==(const ConstIterator& other) const;		///<Equality of iterators
+			bool operator!=(const ConstIterator& other) const;		///<Inequality of iterators
+		private:
+			ConstIterator(typename data_t::const_iterator bucket, typename data_t::const_iterator last);
+			ConstIterator(typename data_t::const_iterator bucket, typename data_t::const_iterator last, typename bucket_t::const_iterator it);
+			typename data_t::const_iterator bucket, last;
+			typename bucket_t::const_iterator it;
+			friend class GradedContainer; ///<Befriending outer class
+		};
+		ConstIterator begin() const;	///<ConstIterator to the first monomial
+		ConstIterator end() const;		///<ConstIterator to just after the final monomial
+
+		/// @brief	ConstIterator to the highest term monomial
+		///	@note	Linear search through the monomials of the top degree only
+		ConstIterator highest_term() const;
+
+		/// @brief	Estimated bytes of the monomials and of the container
+		///	@note	Linear in the number of degrees: the overhead is the nodes and buckets of every \c std::unordered_map and the node of the \c std::map holding it
+		MemoryUsage memory_usage() const;
+
+		///	@brief			Moves each homogeneous component into its own container, leaving \c *this empty
+		///	@param receive	Called as ```receive(degree, component)``` for each nonzero component, in increasing degree;
+		///					\c component is an rvalue \c GradedContainer with the same \c dimensions as \c *this
+		template <class fun>
+		void extract_components(const fun& receive);
+
+		///	@brief		Copies the homogeneous component of given degree into its own container
+		///	@param d	The degree
+		///	@return		The monomials of degree \p d , in a container with the same \c dimensions as \c *this
+		///	@note		Only the bucket of degree \p d is read
+		GradedContainer component(deg_t d) const;
+
+		///	@brief		Moves the homogeneous component of given degree into its own container, removing it from \c *this
+		///	@param d	The degree
+		///	@return		The monomials of degree \p d , in a container with the same \c dimensions as \c *this
+		///	@note		\f$O(\log n)\f$: the bucket of degree \p d is moved, not copied
+		GradedContainer extract_component(deg_t d);
+
+	protected:
+		using BaseContainer<exp_t>::BaseContainer;
+		/// @brief Non const iterator traversing the monomials of a polynomial
+		class Iterator {
+		public:
+			scl_t& coeff();									///<Reference to the coefficient of the monomial
+			Iterator& operator++();							///<Moves to the next monomial
+			bool operator==(const Iterator& other) const;	///<Equality of iterators
+			bool operator!=(const Iterator& other) const;	///<Inequality of iterators
+		private:
+			Iterator(typename data_t::iterator bucket, typename data_t::iterator last);
+			typename data_t::iterator bucket, last;
+			typename bucket_t::iterator it;
+			friend class GradedContainer; ///<Befriending outer class
+		};
+
+		Iterator begin();	///<Iterator to the first monomial
+		Iterator end();		///<Iterator to just after the final monomial
+
+		/// @brief		Adds given monomial to polynomial
+		/// @param kvp	The key-value pair representing the monomial
+		void add(const typename bucket_t::value_type& kvp);
 
 		/// @brief		Subtracts given monomial from polynomial
 		/// @param kvp	The key-value pair representing the monomial
-		void subtract(const std::pair<const std::pair<deg_t, exp_t>, scl_t>& kvp);
+		void subtract(const typename bucket_t::value_type& kvp);
 
 		/// @brief		Multiplies the two given monomials and then adds the product to polynomial
 		/// @param kvp1	The key-value pair representing the first monomial
 		/// @param kvp2	The key-value pair representing the second monomial
-		void multiply_add(const std::pair<const std::pair<deg_t, exp_t>, scl_t >& kvp1, const std::pair<const std::pair <deg_t, exp_t>, scl_t >& kvp2);
+		void multiply_add(const typename bucket_t::value_type& kvp1, const typename bucket_t::value_type& kvp2);
+
+		/// @brief		Adds given polynomial to polynomial bucket by bucket
+		/// @param b	The container of the polynomial we add
+		void add(const GradedContainer& b);
+
+		/// @brief		Subtracts given polynomial from polynomial bucket by bucket
+		/// @param b	The container of the polynomial we subtract
+		void subtract(const GradedContainer& b);
+
+		/// @brief		Multiplies the two given polynomials and then adds the product to polynomial
+		/// @param a	The container of the first polynomial
+		/// @param b	The container of the second polynomial
+		/// @note		The products of a bucket of degree \f$d\f$ and one of degree \f$e\f$ are all added to the bucket of degree \f$d+e\f$
+		void multiply_add(const GradedContainer& a, const GradedContainer& b);
+
+		/// @brief				Multiplies the two given polynomials and then adds the terms of the product up to given degree to polynomial
+		/// @param a			The container of the first polynomial
+		/// @param b			The container of the second polynomial
+		/// @param max_degree	The highest degree of the terms kept
+		/// @note				Only the pairs of buckets whose degrees add up to at most \p max_degree are multiplied
+		void multiply_add(const GradedContainer& a, const GradedContainer& b, deg_t max_degree);
+
+		/// @brief		Multiplies every monomial of polynomial by the given monomial, in place
+		/// @param key	The key of the monomial
+		/// @note		Each bucket is rebuilt in one allocation and moves to the degree shifted by that of the monomial.
+		///				Monomials with the same product (eg if \c exp_t has idempotent variables like \c HalfIdempotentVariables ) are combined
+		void multiply_monomial(const key_t& key);
 	private:
-		void add(const std::pair<deg_t, exp_t> key, scl_t value);
+		size_t monomials = 0;
+		template <bool negate>
+		void add(const bucket_t& b, bucket_t& target);
+		void add(bucket_t& target, const key_t& key, scl_t value);
+		static void reserve(bucket_t& bucket, size_t n); //counts the rehash of a nonempty bucket in the instrumentation
+		void prune(typename data_t::iterator bucket);
 	};
 
 
+	///	@brief	Tag selecting the constructor of \c Polynomial from a sorted range of monomials
+	struct sorted_range_t
+	{
+		explicit sorted_range_t() = default;
+	};
+
+	///	@brief	Tag selecting the constructor of \c Polynomial from a sorted range of monomials
+	inline constexpr sorted_range_t sorted_range{};
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	/// @brief				Class for polynomials in multiple variables with relations
 	/// @tparam container_t	The data storage type/ monomial container to use eg \c DefaultContainer . \n
@@ -173,6 +570,17 @@ namespace symmp
 		/// @warning			It is the user's responsibility to make sure \c coeff!=0
 		Polynomial(int num_var, scl_t coeff, const deg_t* dim_var = nullptr, const std::string* name_var = nullptr);
 
+		///	@brief				Constructs polynomial from a range of nonzero monomials sorted in increasing order, without searching for their positions
+		///	@tparam	iter_t		A forward iterator to pairs of exponent and coefficient eg ```std::vector<std::pair<exp_t,scl_t>>::const_iterator```
+		///	@param	first		The first monomial
+		///	@param	last		Just after the final monomial
+		///	@param	dim_var 	Pointer to the dimensions of the variables; used when \c exp_t does not implement method ``` deg_t degree() const ```
+		///	@param  name_var	Pointer to the names of the variables; used when \c exp_t does not implement ``` std::string  static name(int,int)```
+		/// @warning			It is the user's responsibility to make sure that the monomials are distinct, nonzero and sorted by degree and then exponent
+		///						(for the unordered containers, any order of the exponents within a degree is fine)
+		template <class iter_t>
+		Polynomial(sorted_range_t, iter_t first, iter_t last, const deg_t* dim_var = nullptr, const std::string* name_var = nullptr);
+
 		///	@brief		Returns the number of variables of the polynomial
 		///	@return		The number of variables of \c *this
 		///	@warning	May only be used on nonempty polynomials
@@ -193,7 +601,7 @@ namespace symmp
 		///	@brief 			Multiplication assignment
 		///	@param	other	The polynomial we multiply with \c *this	
 		/// @return			Reference to \c *this
-		///	@todo 			Could this be done in place?
+		///	@note 			In place via \ref multiply_monomial if \p other is a monomial; otherwise the product is moved into \c *this
 		Polynomial& operator*=(const Polynomial& other);
 
 		///	@brief 			Scalar multiplication assignment
@@ -202,32 +610,167 @@ namespace symmp
 		///	@note 			Efficient, in place
 		Polynomial& operator*=(scl_t scalar);
 
+		///	@brief			Multiplication by a monomial, in place
+		///	@param	exp		The exponent of the monomial
+		///	@param	coeff	The coefficient of the monomial
+		/// @return			Reference to \c *this
+		///	@note			The terms are re-keyed without building a product; no monomials are created, but those with the same product
+		///					are combined, which happens if \c exp_t has idempotent variables (eg \c HalfIdempotentVariables with \f$y_i^2=y_i\f$)
+		Polynomial& multiply_monomial(const exp_t& exp, scl_t coeff = 1);
+
+		///	@brief			Fused multiply-add: ```(*this) += coeff*b*c```
+		///	@param	b		The first factor
+		///	@param	c		The second factor
+		///	@param	coeff	The scalar
+		/// @return			Reference to \c *this
+		///	@note			The products of the monomials are added straight into \c *this , without materializing ```b*c``` ;
+		///					if \p coeff is not 1 the smaller factor is scaled instead of the product
+		Polynomial& add_product(const Polynomial& b, const Polynomial& c, scl_t coeff = 1);
+
+		///	@brief			Fused multiply-subtract: ```(*this) -= coeff*b*c```
+		///	@param	b		The first factor
+		///	@param	c		The second factor
+		///	@param	coeff	The scalar
+		/// @return			Reference to \c *this
+		///	@note			Same as \ref add_product with \p -coeff
+		Polynomial& subtract_product(const Polynomial& b, const Polynomial& c, scl_t coeff = 1);
+
 		///	@brief 			Addition of polynomials
 		///	@param	other	The polynomial we add to \c *this
 		/// @return			```(*this)+other```
-		Polynomial operator+(const Polynomial& other) const;
+		Polynomial operator+(const Polynomial& other) const &;
+
+		///	@brief 			Addition of polynomials, reusing the storage of \c *this
+		///	@param	other	The polynomial we add to \c *this
+		/// @return			```(*this)+other```
+		Polynomial operator+(const Polynomial& other) &&;
+
+		///	@brief 			Addition of polynomials, reusing the storage of \p other
+		///	@param	other	The polynomial we add to \c *this
+		/// @return			```(*this)+other```
+		Polynomial operator+(Polynomial&& other) const &;
+
+		///	@brief 			Addition of polynomials, reusing the storage of \c *this
+		///	@param	other	The polynomial we add to \c *this
+		/// @return			```(*this)+other```
+		Polynomial operator+(Polynomial&& other) &&;
 
 		///	@brief 			Subtraction of polynomials
 		///	@param	other	The polynomial we subtract from \c *this
 		/// @return			```(*this)-other```
-		Polynomial operator-(const Polynomial& other) const;
+		Polynomial operator-(const Polynomial& other) const &;
+
+		///	@brief 			Subtraction of polynomials, reusing the storage of \c *this
+		///	@param	other	The polynomial we subtract from \c *this
+		/// @return			```(*this)-other```
+		Polynomial operator-(const Polynomial& other) &&;
+
+		///	@brief 			Subtraction of polynomials, reusing the storage of \p other
+		///	@param	other	The polynomial we subtract from \c *this
+		/// @return			```(*this)-other```
+		Polynomial operator-(Polynomial&& other) const &;
+
+		///	@brief 			Subtraction of polynomials, reusing the storage of \c *this
+		///	@param	other	The polynomial we subtract from \c *this
+		/// @return			```(*this)-other```
+		Polynomial operator-(Polynomial&& other) &&;
 
 		///	@brief 			Multiplication of polynomials
 		///	@param	other	The polynomial we multiply with \c *this
 		/// @return			```(*this)*other```
+		///	@note			Uses \ref parallel_multiply if the number of products of monomials is at least the threshold set by \ref set_parallel_multiplication
 		Polynomial operator*(const Polynomial& other) const;
 
+		///	@brief 			Multiplication of polynomials using several threads
+		///	@details		The monomials of \c *this are split in one chunk per thread, each thread multiplies its chunk by \p other
+		///					into its own partial product and the partial products are then summed pairwise, also in parallel.
+		///	@param	other	The polynomial we multiply with \c *this
+		///	@param	threads	The number of threads; 0 uses the openMP default
+		/// @return			```(*this)*other```
+		///	@note			Falls back to serial multiplication if openMP is not enabled (see \c SYMMP_RUN_LOOP_IN_PARALLEL) or if called from inside a parallel region;
+		///					so it is never nested in the workers of a \c TaskPool .
+		///	@note			The partial products are allocated from the global heap, even if an \c ArenaScope is alive.
+		Polynomial parallel_multiply(const Polynomial& other, int threads = 0) const;
+
+		///	@brief				Configures when \c operator* multiplies in parallel, for all polynomials of this type on all threads
+		///	@param	min_products	Minimum number of products of monomials ```number_of_monomials()*other.number_of_monomials()``` to multiply in parallel; 0 disables parallel multiplication (the default)
+		///	@param	threads			The number of threads; 0 uses the openMP default
+		///	@warning			Not thread safe: call before any multiplication is running
+		static void set_parallel_multiplication(size_t min_products, int threads = 0);
+
 		///	@brief 			Raises polynomial to integer power
 		///	@tparam		T	Any integer type eg ``` int, uint64_t```
 		///	@param 		p	Power we raise \c *this to
 		/// @return			```(*this)^p```
 		/// @warning		Does nothing if \p p<0
 		///	@attention		Raises \c static_assert if \c T is not an integer type
-		///	@todo 			Improve implementation (current is multiplication p-many times; maybe square p/2 times instead?)
+		///	@note			The algorithm is picked according to the shape of \c *this :
+		///					- a sum of few squarefree monomials (eg a single monomial or \f$1+x\f$) is expanded directly via the multinomial theorem, without forming intermediate powers;
+		///					- a polynomial in a single variable is raised by square-and-multiply;
+		///					- otherwise \c *this is multiplied \p p -many times: for sparse polynomials in several variables the squares grow so fast that this is cheaper than squaring.
 		template <class T = int>
 		Polynomial operator^(T p) const;
 
+		///	@brief				Multiplication of polynomials, up to given degree
+		///	@param	other		The polynomial we multiply with \c *this
+		///	@param	max_degree	The highest degree of the terms kept
+		/// @return				The terms of ```(*this)*other``` of degree at most \p max_degree
+		///	@note				The terms of higher degree are never formed: the monomials are paired in increasing degree,
+		///						or by degree bucket in a graded container, and each pairing stops at \p max_degree
+		Polynomial truncated_multiply(const Polynomial& other, deg_t max_degree) const;
+
+		///	@brief 				Raises polynomial to integer power, up to given degree
+		///	@tparam		T		Any integer type eg ``` int, uint64_t```
+		///	@param 		p		Power we raise \c *this to
+		///	@param	max_degree	The highest degree of the terms kept
+		/// @return				The terms of ```(*this)^p``` of degree at most \p max_degree
+		///	@note				Square-and-multiply via \ref truncated_multiply : the truncated squares stay small, unlike those of \c operator^
+		///	@warning			The intermediate powers are truncated too, so the variables must have nonnegative degrees
+		///	@attention			Raises \c static_assert if \c T is not an integer type
+		template <class T = int>
+		Polynomial truncated_power(T p, deg_t max_degree) const;
+
+		///	@brief				Drops the terms above given degree
+		///	@param	max_degree	The highest degree of the terms kept
+		/// @return				The terms of \c *this of degree at most \p max_degree
+		Polynomial truncated(deg_t max_degree) const;
+
+		///	@brief		The homogeneous component of given degree
+		///	@param	d	The degree
+		///	@return		The terms of \c *this of degree \p d
+		///	@note		A copy of the single bucket of degree \p d if the container is graded, and a linear scan otherwise
+		Polynomial homogeneous_component(deg_t d) const;
+
+		///	@brief		Moves the homogeneous component of given degree out of polynomial
+		///	@param	d	The degree
+		///	@return		The terms of \c *this of degree \p d , which are removed from \c *this
+		///	@note		The bucket of degree \p d is moved if the container is graded; otherwise the terms are copied and then subtracted
+		Polynomial extract_homogeneous_component(deg_t d);
+
+		///	@brief		Splits polynomial into its homogeneous components
+		///	@return		The nonzero homogeneous components, keyed by their degree
+		std::map<deg_t, Polynomial> homogeneous_components() const &;
+
+		///	@brief		Splits polynomial into its homogeneous components, moving the monomials out of \c *this if its container is graded
+		///	@return		The nonzero homogeneous components, keyed by their degree
+		std::map<deg_t, Polynomial> homogeneous_components() &&;
+
+		///	@brief		Checks if all monomials have given degree
+		///	@param	d	The degree
+		///	@return		Whether \c *this is homogeneous of degree \p d (this is true for the zero polynomial)
+		bool is_homogeneous(deg_t d) const;
+
+		///	@brief		Estimated memory footprint of polynomial (see \c MemoryUsage )
+		///	@return		The bytes of the monomials and the overhead of the container, including the \c Polynomial object itself
+		///	@note		Does not traverse the monomials (a graded container visits each of its degrees once)
+		MemoryUsage memory_usage() const;
+
 	private:
+		static std::pair<size_t, int>& parallel_settings(); //threshold and number of threads of parallel multiplication
+		bool is_squarefree() const; //every exponent is 0 or 1
+		size_t number_of_used_variables() const; //the number of variables with nonzero exponent in some monomial
+		Polynomial multinomial_power(size_t p) const;
+		Polynomial square_and_multiply(size_t p) const;
 		const std::string* variable_names; //if exp_t does not have the appropriate method
 		template <class fun>
 		void print(scl_t, const exp_t&, std::ostream&, const fun&) const; //Print monomial using given variable names
@@ -235,6 +778,7 @@ namespace symmp
 		void print(std::ostream& os, const fun&) const; //Print polynomial using given variable names
 		template<class cont>
 		friend std::ostream& operator<< (std::ostream&, const Polynomial<cont>&); ///<Befriending the print to ostream function
+		friend class PolynomialWriter; ///<Befriending the buffered writer, which also needs the names of the variables
 	};
 
 	/// @brief				Prints polynomial to output stream
@@ -245,12 +789,25 @@ namespace symmp
 	template <class container_t>
 	std::ostream& operator<<(std::ostream& os, const Polynomial<container_t>& a);
 
-	/// @brief			Polynomial using the default containers \c std::map or \c std::unordered_map
+	/// @brief			Polynomial using the default containers \c std::map or \c MonomialMap
 	/// @tparam _scl	The scalar/coefficient type of the polynomial
 	/// @tparam _exp	The variable/exponent type of the Polynomial eg \c StandardVariables or \c HalfIdempotentVariables
-	/// @tparam _ord	If ```_ord==1``` then \c std::map is used as the container for the polynomial; otherwise \c std::unordered_map is used
+	/// @tparam _ord	If ```_ord==1``` then \c std::map is used as the container for the polynomial; otherwise the open addressing \c MonomialMap is used
 	template <class _scl, class _exp, bool _ord = 1>
-	using Poly = Polynomial<std::conditional_t<_ord, DefaultContainer<_scl, _exp, std::map, 1>, DefaultContainer<_scl, _exp, std::unordered_map, 0>>>;
+	using Poly = Polynomial<std::conditional_t<_ord, DefaultContainer<_scl, _exp, std::map, 1>, DefaultContainer<_scl, _exp, MonomialMap, 0>>>;
+
+	/// @brief			Polynomial using the contiguous sorted container \c FlatContainer
+	/// @tparam _scl	The scalar/coefficient type of the polynomial
+	/// @tparam _exp	The variable/exponent type of the Polynomial eg \c StandardVariables or \c HalfIdempotentVariables
+	template <class _scl, class _exp>
+	using FlatPoly = Polynomial<FlatContainer<_scl, _exp>>;
+
+	/// @brief			Polynomial using the degree-bucketed container \c GradedContainer
+	/// @tparam _scl	The scalar/coefficient type of the polynomial
+	/// @tparam _exp	The variable/exponent type of the Polynomial eg \c StandardVariables or \c HalfIdempotentVariables
+	template <class _scl, class _exp>
+	using GradedPoly = Polynomial<GradedContainer<_scl, _exp>>;
 
 }
+#include "Arena.hpp" //after the declarations, which Arena.hpp needs for ArenaPoly
 #include "impl/Polynomials.ipp"
\ No newline at end of file
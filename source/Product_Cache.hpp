@@ -0,0 +1,81 @@
+#pragma once
+#include "Arena.hpp"
+#include <deque>
+#include <memory>
+#include <mutex>
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains a bounded cache of polynomials, used by \c PolynomialBasis to memoize powers and products of its generators
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	///	@brief	Statistics of a \c ProductCache
+	struct CacheStatistics
+	{
+		size_t hits = 0;	  ///<Number of lookups that found their key
+		size_t misses = 0;	  ///<Number of lookups that did not find their key
+		size_t evictions = 0; ///<Number of entries evicted to respect the capacity
+		size_t entries = 0;	  ///<Number of cached polynomials
+		size_t monomials = 0; ///<Total number of monomials in the cached polynomials
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			Bounded cache of polynomials with hit/miss statistics
+	///	@details		Entries are evicted in insertion order once the total number of cached monomials exceeds the capacity.
+	///					Entries are returned as shared pointers so that eviction never invalidates a polynomial still in use.\n
+	///					Cached polynomials are always allocated from the global heap, even if an \c ArenaScope is alive.
+	///	@tparam key_t	The key type, eg an exponent
+	///	@tparam poly_t	The polynomial type
+	///	@tparam hash_t	The hash function of \p key_t
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class key_t, class poly_t, class hash_t>
+	class ProductCache
+	{
+	public:
+		///	@brief				Constructor
+		///	@param capacity		Maximum total number of monomials in the cache; 0 disables caching
+		///	@param thread_safe	Whether to lock the cache on every access so that it can be shared by several threads
+		ProductCache(size_t capacity = 1 << 18, bool thread_safe = 1);
+
+		///	@brief	Copies the settings only: the copy starts empty
+		ProductCache(const ProductCache &other);
+
+		///	@brief		Looks up the polynomial with given key
+		///	@param key	The key
+		///	@param count Whether to count the lookup in the statistics
+		///	@return 	The polynomial if cached and \c nullptr otherwise
+		std::shared_ptr<const poly_t> find(const key_t &key, bool count = 1) const;
+
+		///	@brief		Caches a copy of given polynomial, evicting the oldest entries if needed
+		///	@param key	The key
+		///	@param poly	The polynomial
+		void insert(const key_t &key, const poly_t &poly);
+
+		///	@brief	Records a hit or miss that was not counted by \ref find
+		void count(bool hit) const;
+
+		///	@brief				Changes the settings and clears the cache
+		///	@param capacity		Maximum total number of monomials in the cache; 0 disables caching
+		///	@param thread_safe	Whether to lock the cache on every access
+		void configure(size_t capacity, bool thread_safe);
+
+		///	@brief	Empties the cache (the statistics are kept)
+		void clear();
+
+		///	@brief	Returns the statistics of the cache
+		CacheStatistics statistics() const;
+
+	private:
+		size_t capacity;
+		bool thread_safe;
+		mutable std::mutex mutex;
+		mutable CacheStatistics stats;
+		std::unordered_map<key_t, std::shared_ptr<const poly_t>, hash_t> entries;
+		std::deque<key_t> order;
+		std::unique_lock<std::mutex> lock() const;
+	};
+}
+#include "impl/Product_Cache.ipp"
@@ -0,0 +1,169 @@
+#pragma once
+#include "Polynomials.hpp"
+#include <map>
+#include <array>
+#include <limits>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains coefficient types that don't silently overflow: integers modulo a prime, with reconstruction from several primes, and checked integers
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	///	@brief	Primes just below \f$2^{62}\f$, for computing modulo several primes and then reconstructing via \ref crt_reconstruct
+	///	@note	Two of them reconstruct any integer of absolute value less than \f$2^{123}\f$, three any less than \f$2^{185}\f$
+	inline constexpr uint64_t modular_primes[] = {4611686018427387847ull, 4611686018427387817ull, 4611686018427387787ull, 4611686018427387761ull};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			Integer modulo an odd prime, usable as the scalar type of a polynomial eg ```Poly<ModularInteger<modular_primes[0]>, StandardVariables<int>>```
+	///	@details		The residue is stored in Montgomery form \f$aR \bmod p\f$ where \f$R=2^{64}\f$, so a multiplication is two 64x64 to 128 bit multiplications
+	///					and a shift instead of a 128 bit division. Division is multiplication by the inverse, so the decompositions of
+	///					\c PolynomialBasis are exact even when the leading coefficient of a generator is not 1.
+	///	@tparam p		The modulus, an odd prime less than \f$2^{63}\f$
+	///	@attention		The arithmetic is modulo \p p : to recover integer coefficients compute modulo enough primes and then use \ref crt_reconstruct
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <uint64_t p>
+	class ModularInteger
+	{
+		static_assert(p % 2 == 1 && p > 2 && p < (uint64_t(1) << 63), "The modulus must be an odd prime less than 2^63");
+
+	public:
+		static constexpr uint64_t modulus = p; ///<The modulus
+
+		///	@brief	Constructs zero
+		ModularInteger();
+
+		///	@brief			Constructs the residue of an integer
+		///	@tparam	T		Any integer type eg \c int or \c int64_t
+		///	@param	value	The integer, reduced modulo \p p (negative integers included)
+		template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+		ModularInteger(T value);
+
+		///	@brief	The residue in \f$[0,p)\f$
+		uint64_t residue() const;
+
+		///	@brief	The residue in \f$[-(p-1)/2,(p-1)/2]\f$, which is the integer itself if its absolute value is less than \f$p/2\f$
+		int64_t balanced() const;
+
+		///	@brief		The multiplicative inverse
+		///	@warning	Calls \c abort() if \c *this is zero
+		ModularInteger inverse() const;
+
+		ModularInteger &operator+=(const ModularInteger &other); ///<Addition assignment
+		ModularInteger &operator-=(const ModularInteger &other); ///<Subtraction assignment
+		ModularInteger &operator*=(const ModularInteger &other); ///<Multiplication assignment
+		ModularInteger &operator/=(const ModularInteger &other); ///<Division assignment (calls \c abort() on division by zero)
+		ModularInteger operator+(const ModularInteger &other) const; ///<Addition
+		ModularInteger operator-(const ModularInteger &other) const; ///<Subtraction
+		ModularInteger operator*(const ModularInteger &other) const; ///<Multiplication
+		ModularInteger operator/(const ModularInteger &other) const; ///<Division (calls \c abort() on division by zero)
+		ModularInteger operator-() const;						 ///<Negation
+		bool operator==(const ModularInteger &other) const;		 ///<Equality
+		bool operator!=(const ModularInteger &other) const;		 ///<Inequality
+
+	private:
+		uint64_t value; //the residue times 2^64, modulo p
+		static ModularInteger from_montgomery(uint64_t value);
+		static uint64_t reduce(uint64_t high, uint64_t low); //(high*2^64+low)/2^64 modulo p, for high<p
+		static uint64_t multiply(uint64_t a, uint64_t b);	 //Montgomery product a*b/2^64 modulo p
+		static constexpr uint64_t negative_inverse();		 //-1/p modulo 2^64
+		static constexpr uint64_t montgomery_square();		 //2^128 modulo p
+	};
+
+	///	@brief		Prints the balanced residue (see \ref ModularInteger::balanced ) to output stream
+	///	@tparam p	The modulus
+	template <uint64_t p>
+	std::ostream &operator<<(std::ostream &os, const ModularInteger<p> &a);
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief			Signed integer that calls \c abort() on overflow instead of wrapping around, usable as the scalar type of a polynomial
+	///	@details		Also aborts on division by zero and on inexact division: the decompositions of \c PolynomialBasis divide by the leading
+	///					coefficients of products of generators, and a remainder would mean the integer coefficients are wrong.
+	///	@tparam T		The underlying signed integer eg \c int64_t or \c int128_t
+	///	@note			Uses the compiler's overflow builtins where available, so the checks only cost a branch on the overflow flag
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template <class T>
+	class CheckedInteger
+	{
+	public:
+		///	@brief	Constructs zero
+		CheckedInteger();
+
+		///	@brief	Constructs from the underlying integer
+		CheckedInteger(T value);
+
+		///	@brief			Constructs from any integer type
+		///	@param	value	The integer
+		///	@warning		Calls \c abort() if \p value is not representable by \p T
+		template <class S, std::enable_if_t<std::is_integral_v<S> && !std::is_same_v<S, T>, int> = 0>
+		CheckedInteger(S value);
+
+		///	@brief	The underlying integer
+		T get() const;
+
+		CheckedInteger &operator+=(const CheckedInteger &other); ///<Addition assignment
+		CheckedInteger &operator-=(const CheckedInteger &other); ///<Subtraction assignment
+		CheckedInteger &operator*=(const CheckedInteger &other); ///<Multiplication assignment
+		CheckedInteger &operator/=(const CheckedInteger &other); ///<Exact division assignment
+		CheckedInteger operator+(const CheckedInteger &other) const; ///<Addition
+		CheckedInteger operator-(const CheckedInteger &other) const; ///<Subtraction
+		CheckedInteger operator*(const CheckedInteger &other) const; ///<Multiplication
+		CheckedInteger operator/(const CheckedInteger &other) const; ///<Exact division
+		CheckedInteger operator-() const;						 ///<Negation
+		bool operator==(const CheckedInteger &other) const;		 ///<Equality
+		bool operator!=(const CheckedInteger &other) const;		 ///<Inequality
+		bool operator<(const CheckedInteger &other) const;		 ///<Less than
+		bool operator>(const CheckedInteger &other) const;		 ///<Greater than
+		bool operator<=(const CheckedInteger &other) const;		 ///<Less than or equal
+		bool operator>=(const CheckedInteger &other) const;		 ///<Greater than or equal
+
+	private:
+		T value;
+		[[noreturn]] static void fail(const char *error);
+	};
+
+	///	@brief	Prints checked integer to output stream (also for 128 bit integers, which have no \c operator<< )
+	template <class T>
+	std::ostream &operator<<(std::ostream &os, const CheckedInteger<T> &a);
+
+	typedef CheckedInteger<int64_t> checked_int64_t; ///<64 bit integer that aborts on overflow
+
+#if defined(__SIZEOF_INT128__)
+	__extension__ typedef __int128 int128_t;		   ///<128 bit integer (GCC and Clang)
+	typedef CheckedInteger<int128_t> checked_int128_t; ///<128 bit integer that aborts on overflow
+#endif
+
+	///	@brief				Reconstructs an integer from its residues modulo distinct primes (Chinese remainder theorem, via Garner's algorithm)
+	///	@tparam	int_t		The integer type of the result eg \c checked_int128_t
+	///	@tparam	p			The distinct prime moduli
+	///	@param	residues	The residues of the integer modulo each prime
+	///	@return				The unique integer \f$x\f$ with the given residues and \f$|x|\le (M-1)/2\f$ where \f$M\f$ is the product of the primes
+	///	@note				The mixed radix digits are taken balanced, so \f$x\f$ is accumulated without ever exceeding \f$M/2\f$ in absolute value:
+	///						if \p int_t is a \c CheckedInteger the reconstruction aborts only if the result itself does not fit.
+	template <class int_t, uint64_t... p>
+	int_t crt_reconstruct(const ModularInteger<p> &...residues);
+
+	///	@brief				Reconstructs a polynomial with integer coefficients from its images modulo distinct primes
+	///	@details			To decompose a polynomial with large coefficients, reduce it modulo a few of the \ref modular_primes with \ref convert_coefficients ,
+	///						decompose the reductions (eg in parallel, one per thread) and reconstruct the decomposition with this function.
+	///	@tparam	target_poly_t	The polynomial type of the result eg ```Poly<checked_int128_t, StandardVariables<int>>```
+	///	@tparam	poly_t		The polynomial types of the images, whose scalars are \c ModularInteger
+	///	@param	result		The zero polynomial the reconstruction is inserted into; it must carry the dimensions (and names) of the variables if needed
+	///	@param	images		The images of the polynomial modulo each prime
+	///	@note				A monomial missing from an image has coefficient 0 modulo that prime
+	template <class target_poly_t, class... poly_t>
+	void crt_reconstruct(target_poly_t &result, const poly_t &...images);
+
+	///	@brief				Converts the coefficients of a polynomial to another scalar type eg reduces them modulo a prime
+	///	@tparam	target_poly_t	The polynomial type of the result eg ```Poly<ModularInteger<modular_primes[0]>, StandardVariables<int>>```
+	///	@tparam	poly_t		The polynomial type of the input eg ```Poly<int64_t, StandardVariables<int>>```
+	///	@param	result		The zero polynomial the converted monomials are inserted into; it must carry the dimensions (and names) of the variables if needed
+	///	@param	a			The polynomial to convert
+	///	@note				Each coefficient is converted via the constructor of the target scalar type, and monomials whose coefficient becomes zero are skipped
+	template <class target_poly_t, class poly_t>
+	void convert_coefficients(target_poly_t &result, const poly_t &a);
+}
+#include "impl/Scalars.ipp"
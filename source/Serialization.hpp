@@ -0,0 +1,89 @@
+#pragma once
+#include "Polynomials.hpp"
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+///	@brief	Defined if files are loaded with \c mmap ; otherwise \c MappedFile reads them into memory
+#define SYMMP_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains the binary format of polynomials and of generating bases, and the memory mapped files they are loaded from
+///	@details	A file starts with a header: the magic bytes \c SYMMPBIN , the format version, a byte order mark, what the file contains
+///				(a list of polynomials or a basis) and the sizes of the scalar, exponent entry and degree types, which must match on loading.
+///				A polynomial is stored as its number of monomials and of variables, followed by the monomials sorted by degree and then exponent, each as the
+///				entries of its exponent and the bytes of its coefficient. So loading is one pass over the file with no searching (see \c sorted_range ).
+///	@warning	The files are in the byte order of the machine that wrote them, and are only read on machines with the same byte order.
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief		Read-only view of the bytes of a whole file
+	///	@details	With \c SYMMP_MMAP the file is memory mapped, so nothing is read until it is touched, and the pages are shared by all processes
+	///				loading the same file. Otherwise the file is read into memory.
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class MappedFile
+	{
+	public:
+		///	@brief		Maps given file
+		///	@param path	The path to the file
+		///	@note		Check \ref is_open to see whether the file could be opened
+		MappedFile(const std::string &path);
+
+		///	@brief	Unmaps the file
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		///	@brief	Whether the file was opened and is nonempty
+		bool is_open() const;
+
+		///	@brief	Pointer to the first byte of the file
+		const char *data() const;
+
+		///	@brief	The number of bytes of the file
+		size_t size() const;
+
+	private:
+		const char *bytes;
+		size_t length;
+#if !defined(SYMMP_MMAP)
+		std::vector<char> buffer;
+#endif
+	};
+
+	///	@brief					Writes polynomials to a binary file
+	///	@tparam	range_t			Any range of polynomials of the same type eg ```std::vector<Poly<int64_t,StandardVariables<int>>>```
+	///	@param	path			The path of the file (overwritten)
+	///	@param	polynomials		The polynomials
+	///	@return					Whether the file was written
+	///	@attention				The scalar type must be trivially copyable (eg \c int64_t or \c ModularInteger ) as the coefficients are stored as their bytes
+	template <class range_t>
+	bool save_polynomials(const std::string &path, const range_t &polynomials);
+
+	///	@brief					Reads polynomials from a binary file written by \ref save_polynomials
+	///	@tparam	poly_t			The polynomial type: any container is fine, but the scalar, exponent entry and degree types must have the same sizes as in the file
+	///	@param	path			The path of the file
+	///	@param	dim_var 		Pointer to the dimensions of the variables; used when \c exp_t does not implement method ``` deg_t degree() const ```
+	///	@param  name_var		Pointer to the names of the variables; used when \c exp_t does not implement ``` std::string  static name(int,int)```
+	///	@return					The polynomials in the order they were saved, or nothing if the file can't be opened or was written with different types or format version
+	///	@warning				Calls \c abort() if the file is truncated
+	template <class poly_t>
+	std::optional<std::vector<poly_t>> load_polynomials(const std::string &path, const typename poly_t::deg_t *dim_var = nullptr, const std::string *name_var = nullptr);
+}
+#include "impl/Serialization.ipp"
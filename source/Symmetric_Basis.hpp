@@ -1,6 +1,13 @@
 #pragma once
 #include "Polynomials.hpp"
+#include "Product_Cache.hpp"
+#include "Task_Pool.hpp"
 #include "Generators.hpp"
+#include "Serialization.hpp"
+#include "Orbit_Polynomials.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
 /////////////////////////////////////////////////////////////////////////
 ///	@file
@@ -12,16 +19,33 @@
 namespace symmp
 {
 
+	/////////////////////////////////////////////////////////////////////////
+	///	@brief		Wrapping array and vector in the same interface
+	///	@tparam T	The value type of the array/vector
+	///	@tparam N	The size if it's an array or 0 if it's a vector
+	/////////////////////////////////////////////////////////////////////////
+	template <class T, size_t N = 0>
+	struct ArrayVectorWrapper;
+
+	///	@brief	Memory statistics of the decompositions of a \c PolynomialBasis (see \c PolynomialBasis::set_memory_limit )
+	struct MemoryStatistics
+	{
+		size_t peak_bytes = 0;	   ///<The largest estimated footprint of the polynomials held by a single decomposition
+		size_t decompositions = 0; ///<Number of decompositions
+		size_t streamed = 0;	   ///<Number of decompositions that streamed their input degree by degree to respect the limit
+	};
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	///	@brief 				The standard variables \f$x_i\f$ in a polynomial, with \f$|x_i|=1\f$ and no relations.
 	///	@details			A monomial \f$x_1^{a_1}\cdots x_n^{a_n}\f$ is stored as the vector \f$[a_1,...,a_n]\f$
 	///	@tparam		T 		The (integral) value type of the exponent vector.
 	///	@tparam		_deg	The (integral) value type used in the degree function.
+	///	@tparam		N 		The number of variables in compile-time; set to 0 if unknown (default).
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	template <class T = int64_t, class _deg = int64_t>
-	struct StandardVariables : public std::vector<T>
+	template <class T = int64_t, class _deg = int64_t, size_t N = 0>
+	struct StandardVariables : public ArrayVectorWrapper<T, N>
 	{
-		using std::vector<T>::vector;
+		using ArrayVectorWrapper<T, N>::ArrayVectorWrapper;
 		typedef _deg deg_t; ///<Degree typedef
 
 		///	@brief	Computes degree of monomial on standard variables \f$x_i\f$
@@ -39,6 +63,11 @@ namespace symmp
 		///	@return 	Degree \f$[a_1+b_1,...,a_n+b_n]\f$
 		StandardVariables operator+(const StandardVariables &b) const;
 
+		///	@brief		Multiplies monomials in place by adding their exponents
+		///	@param 	b 	The exponent \f$[b_1,...,b_n]\f$ we add to ```*this```=\f$[a_1,...,a_n]\f$
+		///	@return 	Reference to ```*this```=\f$[a_1+b_1,...,a_n+b_n]\f$
+		StandardVariables &operator+=(const StandardVariables &b);
+
 		/// @brief	Hashes monomial
 		/// @return Hash of exponent vector (calls \ref generic_hasher)
 		size_t operator()() const;
@@ -49,11 +78,12 @@ namespace symmp
 	///	@details			A monomial \f$x_1^{a_1}\cdots x_n^{a_n}\f$ is stored as the vector \f$[a_1,...,a_n]\f$
 	///	@tparam 	T 		The (integral) value type of the exponent vector.
 	///	@tparam 	_deg 	The (integral) value type used in the degree function.
+	///	@tparam		N 		The number of variables in compile-time; set to 0 if unknown (default).
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	template <class T = int64_t, class _deg = int64_t>
-	struct ElementarySymmetricVariables : public StandardVariables<T, _deg>
+	template <class T = int64_t, class _deg = int64_t, size_t N = 0>
+	struct ElementarySymmetricVariables : public StandardVariables<T, _deg, N>
 	{
-		using StandardVariables<T, _deg>::StandardVariables;
+		using StandardVariables<T, _deg, N>::StandardVariables;
 		typedef _deg deg_t; ///<Degree typedef
 
 		///	@brief	Computes degree of monomial on the \f$e_i\f$
@@ -69,9 +99,11 @@ namespace symmp
 
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	///	@brief					Factory class that provides the general interface of a generating basis for a subring of a polynomial ring.
-	///	@details				Inherit from this class and construct data member \ref _generators through the child class (and optionally \ref generator_names and \ref generator_dimensions). \n
-	///							The child class must also have a method \c find_exponent with signature:
-	///							\code typename new_poly_t::exp_t find_exponent(const typename orig_poly_t::exp_t&); \endcode
+	///	@details				Inherit from this class and call \ref set_number_of_generators in the constructor of the child class (and optionally construct \ref generator_names and \ref generator_dimensions). \n
+	///							The child class must have methods \c find_exponent and \c make_generator with signatures:
+	///							\code typename new_poly_t::exp_t find_exponent(const typename orig_poly_t::exp_t&);
+	///							orig_poly_t make_generator(size_t i); \endcode
+	///							where \c make_generator constructs the \c i -th generator; in lazy mode this is only called the first time the generator is needed.
 	///							Example implementations are \c SymmetricBasis and \c TwistedChernBasis.
 	///	@tparam spec_t  		Used for compile-time polymorphism (CRTP): must be the child class.
 	///	@tparam orig_poly_t 	Type of polynomial on the original variables
@@ -84,20 +116,91 @@ namespace symmp
 		///	@brief		Transform a polynomial on the original variables to one on the generating basis
 		/// @param 	a 	Polynomial on the original variables
 		/// @return 	Polynomial on the new variables
+		///	@note		The temporary products are allocated from an arena (see \c ArenaPoly) which is reset after every step of the reduction
+		///	@note		\p a is split into its homogeneous components which are reduced from the top degree down, so finding the highest term
+		///				only searches the current component (linear search for unordered containers); past the limit of \ref set_memory_limit
+		///				the components are moved out of \p a one at a time instead
 		new_poly_t operator()(orig_poly_t a) const;
 
 		///	@brief		Transform a polynomial on the generating basis into a polynomial on the original variables
 		/// @param 	a 	Polynomial on the new variables
 		/// @return 	Polynomial on the original variables
+		///	@note		The temporary products are allocated from an arena (see \c ArenaPoly) which is reset after every monomial
 		orig_poly_t operator()(const new_poly_t &a) const;
 
+		///	@brief			Transform a symmetric polynomial stored as sums of orbits to one on the generating basis, without expanding it
+		///	@details		The same reduction as the other \c operator() , but the remainder and the products of generators are \c OrbitPolynomial :
+		///					so every step costs about an orbit size less. The generators and their powers are compressed the first time they're needed in the call.
+		///	@tparam	blocks	The number of variables permuted together (see \c OrbitPolynomial ): 1 for \c SymmetricBasis and 2 for \c TwistedChernBasis
+		/// @param 	a 		Symmetric polynomial on the original variables
+		/// @return 		Polynomial on the new variables
+		///	@note			The caches of \ref configure_cache are not used
+		template <size_t blocks>
+		new_poly_t operator()(const OrbitPolynomial<orig_poly_t, blocks> &a) const;
+
+		///	@brief					Transforms a batch of polynomials on the original variables to polynomials on the generating basis, in parallel
+		///	@details				The polynomials are decomposed on a \c TaskPool , starting from the most expensive ones (estimated as leading degree times number of monomials).
+		///							Every worker has its own arena and its own caches of powers and products (with the settings of \ref configure_cache), so workers never wait on each other.\n
+		///							If the range constructs its elements on the fly (eg \c TwistedChernBasis::relations() ) then each element is constructed by the worker
+		///							that transforms it and freed right after, so the inputs are never all stored at once; they are then started in the order of the range,
+		///							as their cost isn't known in advance, and \p seconds includes their construction.
+		///	@tparam	range_t			Any range of \c orig_poly_t eg ```std::vector<orig_poly_t>```
+		/// @param 	polynomials 	Polynomials on the original variables
+		///	@param	threads			The number of threads; 0 uses the openMP default
+		///	@param	seconds			If not null, set to the wall time each polynomial took, in the same order as \p polynomials
+		/// @return 				The polynomials on the new variables, in the same order as \p polynomials
+		///	@note					The per-worker caches are discarded at the end, so they don't contribute to \ref power_cache_statistics and \ref product_cache_statistics
+		template <class range_t>
+		std::vector<new_poly_t> decompose_batch(const range_t &polynomials, int threads = 0, std::vector<double> *seconds = nullptr) const;
+
+		///	@brief					Transforms a batch of polynomials on the generating basis into polynomials on the original variables, in parallel
+		///	@details				Same as \ref decompose_batch but for the other direction of \c operator() (including ranges that construct their elements)
+		///	@tparam	range_t			Any range of \c new_poly_t eg ```std::vector<new_poly_t>```
+		/// @param 	polynomials 	Polynomials on the new variables
+		///	@param	threads			The number of threads; 0 uses the openMP default
+		///	@param	seconds			If not null, set to the wall time each polynomial took, in the same order as \p polynomials
+		/// @return 				The polynomials on the original variables, in the same order as \p polynomials
+		template <class range_t>
+		std::vector<orig_poly_t> expand_batch(const range_t &polynomials, int threads = 0, std::vector<double> *seconds = nullptr) const;
+
+		///	@brief					Decomposes a batch of polynomials in parallel like \ref decompose_batch , passing on each result as soon as it's ready instead of returning them
+		///	@details				\p consume is called as ```consume(i, std::move(result))``` for the \c i -th polynomial of the range, in the order of the range:
+		///							the worker that finishes the next polynomial in that order calls it for that one and every later one that is already done.
+		///							Each result is freed right after \p consume returns, and the polynomials are started in the order of the range, so few results wait at once.
+		///	@tparam	range_t			Any range of \c orig_poly_t eg ```std::vector<orig_poly_t>```
+		///	@tparam	fun				Callable as ```consume(size_t, new_poly_t&&)``` eg a lambda that prints the result
+		/// @param 	polynomials 	Polynomials on the original variables
+		///	@param	consume			Called with the index and the decomposition of each polynomial, never concurrently
+		///	@param	threads			The number of threads; 0 uses the openMP default
+		template <class range_t, class fun>
+		void decompose_stream(const range_t &polynomials, const fun &consume, int threads = 0) const;
+
+		///	@brief					Expands a batch of polynomials in parallel like \ref expand_batch , passing on each result as soon as it's ready instead of returning them
+		///	@details				Same as \ref decompose_stream but for the other direction of \c operator()
+		///	@tparam	range_t			Any range of \c new_poly_t eg ```std::vector<new_poly_t>```
+		///	@tparam	fun				Callable as ```consume(size_t, orig_poly_t&&)```
+		/// @param 	polynomials 	Polynomials on the new variables
+		///	@param	consume			Called with the index and the expansion of each polynomial, never concurrently
+		///	@param	threads			The number of threads; 0 uses the openMP default
+		template <class range_t, class fun>
+		void expand_stream(const range_t &polynomials, const fun &consume, int threads = 0) const;
+
 		///	@brief		Constructor given number of variables
 		/// @param num 	The number of variables for the polynomials
 		PolynomialBasis(int num);
 
 		///	@brief	Returns vector containing the generating basis
+		///	@note	In lazy mode this constructs all the generators that haven't been used yet
 		const std::vector<orig_poly_t> &generators() const;
 
+		///	@brief		Returns the generator of given index, constructing it only if it's the first time it's needed
+		///	@param i	The index of the generator
+		///	@note		Thread-safe: if several threads need the same generator it is constructed once and the others wait for it
+		const orig_poly_t &generator(size_t i) const;
+
+		///	@brief	The number of generators
+		size_t number_of_generators() const;
+
 		///	@brief	Returns vector containing the dimensions of the generating basis (can be empty!)
 		const std::vector<typename new_poly_t::deg_t> &dimensions() const;
 
@@ -107,9 +210,72 @@ namespace symmp
 		///	@brief	The number of (the original) variables of the polynomial ring
 		const int number_of_variables;
 
+		///	@brief				Configures the caches of powers \f$g_i^p\f$ of the generators and of products \f$g_1^{p_1}\cdots g_k^{p_k}\f$ of their powers
+		///	@details			Both caches are used whenever a monomial on the generators is expanded and are shared by all calls of both \c operator() .
+		///						Changing the settings clears the caches.
+		///	@param capacity		Maximum number of monomials in each cache; 0 disables caching
+		///	@param thread_safe	Whether the caches are locked on access. Must be 1 if \c *this is used by several threads at once.
+		void configure_cache(size_t capacity, bool thread_safe = 1);
+
+		///	@brief	Hit/miss statistics of the cache of powers of generators
+		CacheStatistics power_cache_statistics() const;
+
+		///	@brief	Hit/miss statistics of the cache of products of powers of generators (one lookup per expanded monomial with at least two distinct generators)
+		CacheStatistics product_cache_statistics() const;
+
+		///	@brief			Bounds the memory a decomposition holds by streaming its input degree by degree
+		///	@details		By default the input \c a of a decomposition is split into all of its homogeneous components at once, which for the ungraded
+		///					containers briefly holds a copy of \c a next to them. If that split is estimated to exceed \p bytes (see \c Polynomial::memory_usage )
+		///					then the decomposition instead moves the top component out of \c a , reduces it completely and only then takes the next one;
+		///					any terms the products have in other degrees go back into \c a .
+		///	@param bytes	The limit; 0 never streams (the default). A nonzero limit also tracks the peak footprint (see \ref track_memory ).
+		///	@note			Streaming is cheapest for graded containers, where moving a component out is \f$O(\log n)\f$; for the others each component is copied and
+		///					subtracted from \c a , which is linear in its size.
+		///	@warning		Not thread safe: call before any decomposition is running
+		void set_memory_limit(size_t bytes);
+
+		///	@brief			Whether the decompositions track their peak footprint for \ref memory_statistics even without a memory limit
+		///	@param enabled	Off by default, as it estimates the footprint of every component after each step of the reduction
+		///	@warning		Not thread safe: call before any decomposition is running
+		void track_memory(bool enabled);
+
+		///	@brief	Memory statistics of all decompositions since the last \ref reset_memory_statistics , including those of \ref decompose_batch
+		///	@note	\c peak_bytes is 0 unless there is a memory limit or \ref track_memory is enabled. The footprint of a decomposition counts the remainder (the input, or its components), the current product and the result;
+		///			the caches are bounded separately (see \ref configure_cache ) and the arena is reset after every step.
+		MemoryStatistics memory_statistics() const;
+
+		///	@brief	Resets the statistics of \ref memory_statistics
+		void reset_memory_statistics();
+
+		///	@brief			Writes the generators, their dimensions and their names to a binary file (see Serialization.hpp)
+		///	@param path		The path of the file (overwritten)
+		///	@return			Whether the file was written
+		///	@note			In lazy mode this constructs all the generators that haven't been used yet
+		bool save(const std::string &path) const;
+
+		///	@brief			Takes the generators from a binary file written by \ref save instead of constructing them
+		///	@details		The file is memory mapped and each generator is only decoded the first time it's needed, exactly like the lazy mode
+		///					(so loading a basis with large generators costs almost nothing until they are used). The intended use is
+		///					\code TwistedChernBasis<xy, ch> basis(n, 1); if (!basis.load(path)) basis.save(path); \endcode
+		///	@param path		The path of the file
+		///	@return			Whether the generators were loaded: 0 if the file can't be opened, was written with different types or format version,
+		///					or with a different number of variables, generators, dimensions or names; then \c *this is unchanged
+		///	@warning		Not thread-safe: no other thread may use \c *this during the call. Calls \c abort() if the file is truncated.
+		bool load(const std::string &path);
+
 	protected:
-		///	@brief	The generators of the polynomial basis, constructed in the inheriting class
-		std::vector<orig_poly_t> _generators;
+		///	@brief			Sets up the generators, to be called by the constructor of the inheriting class
+		///	@param count	The number of generators
+		///	@param lazy		Whether each generator is only constructed the first time it's needed (by \ref generator ,
+		///					\ref generators or by an expansion/decomposition using it); otherwise all are constructed now
+		void set_number_of_generators(size_t count, bool lazy);
+
+		///	@brief	The generators of the polynomial basis, constructed with \c make_generator of the inheriting class
+		///	@note	Entries whose flag in \ref generator_flags hasn't been set are default constructed placeholders
+		mutable std::vector<orig_poly_t> _generators;
+
+		///	@brief	One flag per generator, set once the generator is constructed
+		mutable std::vector<std::once_flag> generator_flags;
 
 		///	@brief	The dimensions of the generators, optionally constructed in the inheriting class
 		std::vector<typename new_poly_t::deg_t> generator_dimensions;
@@ -117,33 +283,80 @@ namespace symmp
 		///	@brief	The names of the generators, optionally constructed in the inheriting class
 		std::vector<std::string> generator_names;
 
+		///	@brief	A list of distinct monomials on the original variables
+		typedef std::vector<std::pair<typename orig_poly_t::exp_t, typename orig_poly_t::scl_t>> terms_t;
+
+		///	@brief					Builds a polynomial from a range of items (eg the combinations of a \c CombinationGenerator ) by splitting it in slices built in parallel on a \c TaskPool
+		///	@details				Used by the inheriting classes to construct large generators. The slices are concatenated in order and the
+		///							polynomial is loaded in one go with the \c sorted_range constructor, so no monomial is searched for or merged.
+		///	@param size				The number of items
+		///	@param terms_per_item	The number of terms each item contributes (used to size the slices)
+		///	@param build			Called as ```build(first, last)``` and returns the \c terms_t made from the items of rank in \f$[first,last)\f$,
+		///							in decreasing order (the order of the combinations of a \c CombinationGenerator )
+		///	@return					The polynomial made from all items
+		template <class fun>
+		static orig_poly_t build_in_parallel(size_t size, size_t terms_per_item, const fun &build);
+
 	private:
-		orig_poly_t compute_product(const typename new_poly_t::exp_t &exponent) const;
+		typedef typename new_poly_t::exp_t new_exp_t;
+		struct Caches
+		{
+			//(generator index, power) are stored as index+power*number of generators
+			ProductCache<size_t, orig_poly_t, std::hash<size_t>> powers;
+			//products are stored by exponent prefix: an exponent with the last few nonzero entries set to zero
+			ProductCache<new_exp_t, orig_poly_t, implementation_details::hash_only_exp<new_exp_t>> products;
+		};
+		mutable Caches caches; //shared by all calls of operator()
+		size_t memory_limit = 0;
+		bool memory_tracking = 0;
+		mutable std::atomic<size_t> peak_bytes{0}, decompositions{0}, streamed{0}; //updated by every decomposition, possibly from several workers
+		std::shared_ptr<const MappedFile> generator_file; //set by load: the generators are decoded from it instead of constructed
+		std::vector<uint64_t> generator_offsets;		   //the offset of each generator in generator_file
+		new_poly_t decompose(orig_poly_t a, Caches &caches, MonotonicArena &arena) const;
+		orig_poly_t expand(const new_poly_t &a, Caches &caches, MonotonicArena &arena) const;
+		//consume is nullptr to return the results, or is called with each of them in order as soon as it and those before it are ready
+		template <class poly_t, class range_t, class sink, class fun>
+		auto run_batch(const range_t &polynomials, int threads, std::vector<double> *seconds, const sink &consume, const fun &transform) const;
+		std::shared_ptr<const orig_poly_t> power(size_t i, size_t p, Caches &caches) const;
+		orig_poly_t compute_product(const new_exp_t &exponent, Caches &caches) const;
 	};
 
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	///	@brief				Class for symmetric polynomials with no relations, allowing transformation from \f$x_i\f$ variables to \f$e_i\f$ variables and vice-versa.
+	///	@details			If the exponents have compile-time size (eg ```StandardVariables<T,_deg,N>``` with \c N>0, see \c FixedSymmetricBasis) then no exponent touches the heap
+	///						and the loops over the variables have compile-time bounds.
 	///	@tparam x_poly_t 	Type of Polynomial on the Standard_Variables \f$x_i\f$
 	///	@tparam e_poly_t 	The of Polynomial on the ElementarySymmetricVariables \f$e_i\f$
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	template <class x_poly_t, class e_poly_t>
 	class SymmetricBasis : public PolynomialBasis<SymmetricBasis<x_poly_t, e_poly_t>, x_poly_t, e_poly_t>
 	{
+		typedef typename x_poly_t::exp_t x_t;
+		typedef typename e_poly_t::exp_t e_t;
+
 	public:
 		///	@brief		Constructor given number of variables
-		///	@param num 	The number of variables for our symmetric polynomials
-		SymmetricBasis(int num);
+		///	@param num 	The number of variables for our symmetric polynomials; defaults to the compile-time size of the exponents (if any)
+		///	@param lazy	Whether each elementary symmetric polynomial is only constructed the first time it's needed
+		///	@warning	Calls \c abort() if \p num is different from the compile-time size of the exponents
+		SymmetricBasis(int num = implementation_details::static_size<x_t>::value, bool lazy = 0);
 
 	private:
 		using PolynomialBasis<SymmetricBasis<x_poly_t, e_poly_t>, x_poly_t, e_poly_t>::number_of_variables;
-		using PolynomialBasis<SymmetricBasis<x_poly_t, e_poly_t>, x_poly_t, e_poly_t>::_generators;
-		typedef typename x_poly_t::exp_t x_t;
-		typedef typename e_poly_t::exp_t e_t;
 		x_poly_t get_elementary_symmetric(int i) const;
+		x_poly_t make_generator(size_t i) const;
 		auto find_exponent(const x_t &term) const -> e_t;
 
 		///	@brief	Befriending parent for CRTP.
 		friend class PolynomialBasis<SymmetricBasis<x_poly_t, e_poly_t>, x_poly_t, e_poly_t>;
 	};
+
+	///	@brief			\c SymmetricBasis on \p N variables fixed in compile-time, with exponents stored in \c std::array
+	///	@tparam N		The number of variables
+	///	@tparam _scl	The scalar/coefficient type of the polynomials
+	///	@tparam T		The (integral) value type of the exponents
+	///	@tparam _deg	The (integral) value type used in the degree function
+	template <size_t N, class _scl = int64_t, class T = int64_t, class _deg = int64_t>
+	using FixedSymmetricBasis = SymmetricBasis<GradedPoly<_scl, StandardVariables<T, _deg, N>>, GradedPoly<_scl, ElementarySymmetricVariables<T, _deg, N>>>;
 }
 #include "impl/Symmetric_Basis.ipp"
\ No newline at end of file
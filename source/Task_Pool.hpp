@@ -0,0 +1,50 @@
+#pragma once
+#include "impl/Details.ipp"
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////
+///	@file
+///	@brief 		Contains a work-stealing pool of threads used for batches of decompositions
+/////////////////////////////////////////////////////////////////////////
+
+namespace symmp
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///	@brief		Runs a list of independent tasks on a pool of openMP threads with work stealing
+	///	@details	The tasks are dealt round-robin to one queue per worker. Each worker runs the tasks of its own queue
+	///				in order and, once that is empty, steals the next task from the queue of another worker.
+	///				So if the tasks are listed from the most to the least expensive, the large tasks start first
+	///				and the small ones fill in the gaps at the end.
+	///	@note		If openMP is not enabled (see \c SYMMP_RUN_LOOP_IN_PARALLEL) or the pool is used inside a parallel region,
+	///				the calling thread runs every task by itself.
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class TaskPool
+	{
+	public:
+		///	@brief			Constructor
+		///	@param threads	The number of workers; 0 uses the openMP default (1 if openMP is not enabled)
+		TaskPool(int threads = 0);
+
+		///	@brief	The number of workers; the worker index passed to a task is always less than this
+		int threads() const;
+
+		///	@brief			Runs all given tasks and returns once they are done
+		///	@param tasks	The tasks in the order they should be started
+		///	@param run		Called as ```run(task, worker)``` for each \c task in \p tasks, where \c worker is the index of the worker running it
+		///	@warning		\p run is called concurrently from several threads
+		template <class fun>
+		void run(const std::vector<size_t> &tasks, const fun &run) const;
+
+	private:
+		int workers;
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<size_t> tasks;
+		};
+	};
+}
+#include "impl/Task_Pool.ipp"
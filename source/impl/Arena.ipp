@@ -0,0 +1,113 @@
+#pragma once
+#include "../Arena.hpp"
+
+///	@file
+///	@brief Implementation of Arena.hpp
+
+namespace symmp
+{
+
+	inline MonotonicArena::MonotonicArena(size_t block_size) : block_size(block_size), current(0), offset(0), used(0) {}
+
+	inline MonotonicArena::~MonotonicArena()
+	{
+		release();
+	}
+
+	inline void MonotonicArena::release()
+	{
+		for (const auto &block : blocks)
+			std::pmr::new_delete_resource()->deallocate(block.first, block.second, alignof(std::max_align_t));
+		blocks.clear();
+	}
+
+	inline void MonotonicArena::reset()
+	{
+		if (blocks.size() > 1)
+		{ //coalesce so that next time everything fits in one block
+			block_size = capacity();
+			release();
+		}
+		current = 0;
+		offset = 0;
+		used = 0;
+	}
+
+	inline size_t MonotonicArena::bytes_used() const
+	{
+		return used;
+	}
+
+	inline size_t MonotonicArena::capacity() const
+	{
+		size_t total = 0;
+		for (const auto &block : blocks)
+			total += block.second;
+		return total;
+	}
+
+	inline void *MonotonicArena::do_allocate(size_t bytes, size_t alignment)
+	{
+		while (current < blocks.size())
+		{
+			auto address = reinterpret_cast<uintptr_t>(blocks[current].first) + offset;
+			const size_t padding = (alignment - address % alignment) % alignment;
+			if (offset + padding + bytes <= blocks[current].second)
+			{
+				offset += padding + bytes;
+				used += bytes;
+				return reinterpret_cast<void *>(address + padding);
+			}
+			current++;
+			offset = 0;
+		}
+		const size_t size = std::max(blocks.empty() ? block_size : 2 * blocks.back().second, bytes + alignment);
+		blocks.emplace_back(static_cast<char *>(std::pmr::new_delete_resource()->allocate(size, alignof(std::max_align_t))), size);
+		current = blocks.size() - 1;
+		return do_allocate(bytes, alignment);
+	}
+
+	inline void MonotonicArena::do_deallocate(void *, size_t, size_t) {}
+
+	inline bool MonotonicArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+	{
+		return this == &other;
+	}
+
+	inline ArenaScope::ArenaScope(std::pmr::memory_resource *arena) : previous(current_arena())
+	{
+		current_arena() = arena;
+	}
+
+	inline ArenaScope::~ArenaScope()
+	{
+		current_arena() = previous;
+	}
+
+	inline std::pmr::memory_resource *ArenaScope::current()
+	{
+		return current_arena();
+	}
+
+	inline std::pmr::memory_resource *&ArenaScope::current_arena()
+	{
+		thread_local std::pmr::memory_resource *arena = std::pmr::new_delete_resource();
+		return arena;
+	}
+
+	template <typename T>
+	ArenaAllocator<T>::ArenaAllocator() : std::pmr::polymorphic_allocator<T>(ArenaScope::current()) {}
+
+	template <typename T>
+	ArenaAllocator<T>::ArenaAllocator(std::pmr::memory_resource *resource) : std::pmr::polymorphic_allocator<T>(resource) {}
+
+	template <typename T>
+	template <typename U>
+	ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U> &other) : std::pmr::polymorphic_allocator<T>(other.resource()) {}
+
+	template <typename T>
+	ArenaAllocator<T> ArenaAllocator<T>::select_on_container_copy_construction() const
+	{
+		return ArenaAllocator();
+	}
+}
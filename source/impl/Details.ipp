@@ -1,6 +1,8 @@
 #pragma once
+#include <algorithm>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include "stddef.h"
 
 ///	@file
@@ -8,9 +10,12 @@
 
 #if defined SYMMP_USE_OPEN_MP & defined _OPENMP
 ///	@brief		Macro that parallelizes certain loops via openMP if SYMMP_USE_OPEN_MP is defined, and does nothing otherwise
-///	@details	Only used for the loops in \c print_half_idempotent_relations and \c pontryagin_via_chern \n
+///	@details	No longer used by the library itself (batches are run on a \c TaskPool ) but kept for user code \n
 ///				To configure the number of threads please set the environment variable OMP_NUM_THREADS on the console before running any executable
 #define SYMMP_RUN_LOOP_IN_PARALLEL _Pragma("omp parallel for schedule(dynamic)")
+///	@brief		Defined if openMP is enabled in the library; used by the parallel multiplication of polynomials (see \c Polynomial::parallel_multiply)
+#define SYMMP_OPEN_MP_ENABLED
+#include <omp.h>
 #if defined _MSC_VER
 #pragma message("symmp: openMP enabled!")
 #else
@@ -18,7 +23,7 @@
 #endif
 #else
 ///	@brief		Macro that parallelizes certain loops via openMP if SYMMP_USE_OPEN_MP is defined, and does nothing otherwise
-///	@details	Only used for the loops in \c print_half_idempotent_relations and \c pontryagin_via_chern \n
+///	@details	No longer used by the library itself (batches are run on a \c TaskPool ) but kept for user code \n
 ///				To configure the number of threads please set the environment variable OMP_NUM_THREADS on the console before running any executable
 #define SYMMP_RUN_LOOP_IN_PARALLEL
 #if defined _MSC_VER
@@ -35,26 +40,222 @@ namespace symmp
 	///Contains various implementation details such as SFINAE
 	namespace implementation_details {
 
+		template <typename T>
+		static constexpr std::false_type test_stored_degree(...);
+
+		template <typename T>
+		static constexpr std::bool_constant<T::stores_degree> test_stored_degree(int);
+
+		///Detects if the exponent type keeps its own degree (eg \c PackedStandardVariables) so it can be used as the monomial key by itself
+		template <typename T>
+		using has_stored_degree = decltype(test_stored_degree<T>(0));
+
+		template <typename T>
+		static constexpr std::integral_constant<size_t, 0> test_static_size(...);
+
+		template <typename T>
+		static constexpr std::integral_constant<size_t, T::static_size> test_static_size(int);
+
+		///The number of variables of the exponent type if known in compile-time (eg \c StandardVariables with \c N>0 or \c PackedStandardVariables) and 0 otherwise
+		template <typename T>
+		using static_size = decltype(test_static_size<T>(0));
+
+		template <typename T>
+		static constexpr std::false_type test_graded(...);
+
+		template <typename T>
+		static constexpr std::bool_constant<T::graded> test_graded(int);
+
+		///Detects if the monomial container is split into buckets by degree (eg \c GradedContainer)
+		template <typename T>
+		using is_graded_container = decltype(test_graded<T>(0));
+
+		template <typename T>
+		static constexpr std::false_type test_add_assign_existence(...);
+
+		template <typename T>
+		static constexpr decltype(std::declval<T &>() += std::declval<const T &>(), std::true_type()) test_add_assign_existence(int);
+
+		///Detects if the exponent type can be multiplied in place via \c operator+=
+		template <typename T>
+		using has_add_assign_function = decltype(test_add_assign_existence<T>(0));
+
+		///Degree+exponent key that also stores the hash of the exponent (used if \c SYMMP_CACHE_HASH is defined)
 		template <typename _exp>
-		using pair_t = std::pair<typename _exp::deg_t, _exp>;
+		struct hashed_pair
+		{
+			typename _exp::deg_t first; ///<The degree
+			_exp second;				///<The exponent
+			size_t hash;				///<The hash of the exponent
+			///Compares the hashes first, so that different keys in the same bucket are told apart without comparing the exponents
+			bool operator==(const hashed_pair& other) const { return hash == other.hash && first == other.first && second == other.second; }
+			bool operator!=(const hashed_pair& other) const { return !(*this == other); }
+			///Same order as \c std::pair
+			bool operator<(const hashed_pair& other) const { return first < other.first || (first == other.first && second < other.second); }
+		};
+
+		//If SYMMP_CACHE_HASH is defined before including any header of this library, the hash of every exponent is stored next to it in the
+		//monomial keys: it is computed once when the key is made (or multiplied) instead of on every lookup and rehash of an unordered container.
+		//This costs one size_t per monomial and, in the ordered containers which don't need it, one hash per key.
+		//Exponents that store their own degree (eg PackedHalfIdempotentVariables) are their own keys and are always hashed directly.
+#if defined(SYMMP_CACHE_HASH)
+		template <typename _exp>
+		using degree_exponent_pair = hashed_pair<_exp>;
+#else
+		template <typename _exp>
+		using degree_exponent_pair = std::pair<typename _exp::deg_t, _exp>;
+#endif
+
+		///The monomial key (degree+exponent) used by the containers: a \c std::pair unless the exponent already stores its degree
+		template <typename _exp, bool = has_stored_degree<_exp>::value>
+		struct key_traits
+		{
+			typedef degree_exponent_pair<_exp> type;
+			static constexpr bool cached_hash = std::is_same_v<type, hashed_pair<_exp>>;
+			static type make(typename _exp::deg_t degree, const _exp& exponent)
+			{
+				if constexpr (cached_hash)
+					return type{degree, exponent, exponent()};
+				else
+					return type(degree, exponent);
+			}
+			static typename _exp::deg_t degree(const type& key) { return key.first; }
+			static const _exp& exponent(const type& key) { return key.second; }
+			static size_t hash(const type& key)
+			{
+				if constexpr (cached_hash)
+					return key.hash;
+				else
+					return key.second();
+			}
+			static type multiply(const type& a, const type& b) { return make(a.first + b.first, a.second + b.second); }
+			///Writes the product of the keys in \p out, reusing its storage if the exponent can be multiplied in place
+			static void multiply(type& out, const type& a, const type& b)
+			{
+				out.first = a.first + b.first;
+				if constexpr (has_add_assign_function<_exp>::value)
+				{
+					out.second = a.second;
+					out.second += b.second;
+				}
+				else
+					out.second = a.second + b.second;
+				if constexpr (cached_hash)
+					out.hash = out.second();
+			}
+		};
+
+		template <typename _exp>
+		struct key_traits<_exp, true>
+		{
+			typedef _exp type;
+			static const type& make(typename _exp::deg_t, const _exp& exponent) { return exponent; }
+			static typename _exp::deg_t degree(const type& key) { return key.degree(); }
+			static const _exp& exponent(const type& key) { return key; }
+			static size_t hash(const type& key) { return key(); }
+			static type multiply(const type& a, const type& b) { return a + b; }
+			static void multiply(type& out, const type& a, const type& b)
+			{
+				if constexpr (has_add_assign_function<_exp>::value)
+				{
+					out = a;
+					out += b;
+				}
+				else
+					out = a + b;
+			}
+		};
+
+		template <typename _exp>
+		using pair_t = typename key_traits<_exp>::type;
+
+		template <typename T>
+		static constexpr std::false_type test_capacity_existence(...);
+
+		template <typename T>
+		static constexpr decltype(std::declval<const T &>().capacity(), std::true_type()) test_capacity_existence(int);
+
+		///Detects if the exponent type keeps its entries on the heap (eg \c StandardVariables with \c N==0 , which is a \c std::vector)
+		template <typename T>
+		using has_capacity_function = decltype(test_capacity_existence<T>(0));
+
+		///The heap bytes of the exponent of given monomial key: its capacity if it's a vector, and 0 if its entries are stored inline (eg \c std::array or packed)
+		template <typename _exp>
+		size_t exponent_heap_bytes(const pair_t<_exp>& key)
+		{
+			if constexpr (has_capacity_function<_exp>::value)
+				return key_traits<_exp>::exponent(key).capacity() * sizeof(*key_traits<_exp>::exponent(key).data());
+			else
+				return 0;
+		}
+
+		template <typename T>
+		static constexpr std::false_type test_allocated_bytes_existence(...);
+
+		template <typename T>
+		static constexpr decltype(std::declval<const T &>().allocated_bytes(), std::true_type()) test_allocated_bytes_existence(int);
+
+		///Detects if the map reports the bytes it allocated (eg \c MonomialMap)
+		template <typename T>
+		using has_allocated_bytes_function = decltype(test_allocated_bytes_existence<T>(0));
+
+		///The bytes a map allocated besides its key-value pairs: the slack of \c MonomialMap or, for a \c std::unordered_map , a link and a cached hash per node and a pointer per bucket
+		template <typename map_t>
+		size_t unordered_overhead(const map_t& map)
+		{
+			if constexpr (has_allocated_bytes_function<map_t>::value)
+				return map.allocated_bytes() - map.size() * sizeof(typename map_t::value_type);
+			else
+				return map.size() * 2 * sizeof(void*) + map.bucket_count() * sizeof(void*);
+		}
+
+		///The bytes of a node of a \c std::map besides its key-value pair: three links and the colour
+		inline constexpr size_t tree_node_overhead = 4 * sizeof(void*);
+
+		///The monomials of a container sorted by degree, so that the products up to some degree are found by stopping early
+		template <typename _exp, typename range_t>
+		std::vector<const typename range_t::value_type*> sorted_by_degree(const range_t& range)
+		{
+			std::vector<const typename range_t::value_type*> sorted;
+			sorted.reserve(range.size());
+			for (const auto& pair : range)
+				sorted.push_back(&pair);
+			std::stable_sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return key_traits<_exp>::degree(a->first) < key_traits<_exp>::degree(b->first); });
+			return sorted;
+		}
 
 		///Given a pair, hash only the second parameter
 		template <typename _exp>
 		struct hash_only_exp
 		{
-			///Hash only second parameter
+			///Hash only second parameter (or return its stored hash)
 			auto operator()(const pair_t<_exp>& pair) const
 			{
-				return pair.second();
+				return key_traits<_exp>::hash(pair);
 			}
 
-			auto operator()(const _exp& a) const {
+			///Hash exponent (only when it is not the key itself)
+			template <typename T = _exp, std::enable_if_t<!std::is_same_v<T, pair_t<_exp>>, int> = 0>
+			auto operator()(const T& a) const {
 				return a();
 			}
 		};
 
+		//selected by specialization rather than std::conditional_t so that only the chosen container is formed with _arg...
+		template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+		struct container_selector
+		{
+			typedef _cnt<pair_t<_exp>, _scl, _arg...> type;
+		};
+
+		template <class _scl, class _exp, template<class...> class _cnt, class ... _arg>
+		struct container_selector<_scl, _exp, _cnt, 0, _arg...>
+		{
+			typedef _cnt<pair_t<_exp>, _scl, hash_only_exp<_exp>, _arg...> type;
+		};
+
 		template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
-		using container_wrapper = std::conditional_t<_ord, _cnt<pair_t<_exp>, _scl, _arg...>, _cnt<pair_t<_exp>, _scl, hash_only_exp<_exp>, _arg...>>;
+		using container_wrapper = typename container_selector<_scl, _exp, _cnt, _ord, _arg...>::type;
 
 		template <typename T>
 		static constexpr std::false_type test_degree_existence(...);
@@ -0,0 +1,147 @@
+#pragma once
+#include "../Evaluation.hpp"
+
+///	@file
+///	@brief Implementation of Evaluation.hpp
+
+namespace symmp
+{
+
+	template <typename value_t>
+	EvaluationPlan<value_t>::EvaluationPlan() : variables(0), max_depth(0), constant(0), powers(0) {}
+
+	template <typename value_t>
+	template <class container_t>
+	EvaluationPlan<value_t>::EvaluationPlan(const Polynomial<container_t> &a, int number_of_variables) : EvaluationPlan()
+	{
+		variables = number_of_variables;
+		//every monomial as its nonzero (variable, exponent) pairs, in the order of the variables
+		typedef std::vector<std::pair<uint32_t, uint32_t>> factors_t;
+		std::vector<std::pair<factors_t, value_t>> monomials;
+		for (auto it = a.begin(); it != a.end(); ++it)
+		{
+			const auto &exponent = it.exponent();
+			variables = std::max(variables, static_cast<int>(exponent.size()));
+			factors_t factors;
+			for (size_t i = 0; i < exponent.size(); i++)
+				if (exponent[i] != 0)
+					factors.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(exponent[i])});
+			if (factors.empty())
+				constant = value_t(it.coeff());
+			else
+				monomials.push_back({std::move(factors), value_t(it.coeff())});
+		}
+		//the table of powers holds x_v,...,x_v^max for every variable
+		max_exponent.assign(variables, 0);
+		for (const auto &monomial : monomials)
+			for (const auto &factor : monomial.first)
+				max_exponent[factor.first] = std::max(max_exponent[factor.first], factor.second);
+		power_offset.assign(variables, 0);
+		for (int v = 0; v < variables; v++)
+		{
+			power_offset[v] = powers;
+			powers += max_exponent[v];
+		}
+		//in lexicographic order every monomial shares the longest possible path with the previous one, so the tree is traversed depth first
+		std::sort(monomials.begin(), monomials.end(), [](const auto &x, const auto &y) { return x.first < y.first; });
+		const factors_t *previous = nullptr;
+		for (auto &monomial : monomials)
+		{
+			const auto &factors = monomial.first;
+			size_t common = 0;
+			if (previous)
+				while (common < previous->size() && common < factors.size() && (*previous)[common] == factors[common])
+					common++;
+			for (size_t d = common; d < factors.size(); d++)
+				steps.push_back({static_cast<uint32_t>(d + 1), power_offset[factors[d].first] + factors[d].second - 1, d + 1 == factors.size() ? static_cast<int64_t>(coefficients.size()) : -1});
+			max_depth = std::max(max_depth, static_cast<uint32_t>(factors.size()));
+			coefficients.push_back(monomial.second);
+			previous = &factors;
+		}
+	}
+
+	template <typename value_t>
+	int EvaluationPlan<value_t>::number_of_variables() const
+	{
+		return variables;
+	}
+
+	template <typename value_t>
+	size_t EvaluationPlan<value_t>::number_of_multiplications() const
+	{
+		size_t count = coefficients.size(); //by the coefficients
+		for (const auto &step : steps)
+			count += (step.depth > 1);
+		for (auto max : max_exponent)
+			count += max - (max != 0);
+		return count;
+	}
+
+	template <typename value_t>
+	value_t EvaluationPlan<value_t>::operator()(const std::vector<value_t> &point) const
+	{
+		value_t result;
+		evaluate(point.data(), 1, &result);
+		return result;
+	}
+
+	template <typename value_t>
+	void EvaluationPlan<value_t>::evaluate(const value_t *points, size_t count, value_t *results) const
+	{
+		//every loop runs over the whole block (the lanes past the last point hold leftovers), so its bounds are compile-time constants
+		std::vector<value_t> table(static_cast<size_t>(powers) * block, value_t(0));
+		std::vector<value_t> path(static_cast<size_t>(max_depth + 1) * block, value_t(0));
+		value_t sums[block];
+		for (size_t start = 0; start < count; start += block)
+		{
+			const size_t lanes = std::min(block, count - start);
+			for (int v = 0; v < variables; v++)
+			{
+				if (max_exponent[v] == 0)
+					continue;
+				value_t *const x = &table[static_cast<size_t>(power_offset[v]) * block];
+				std::copy(points + static_cast<size_t>(v) * count + start, points + static_cast<size_t>(v) * count + start + lanes, x);
+				std::fill(x + lanes, x + block, value_t(0)); //so the leftovers don't overflow
+				value_t *power = x;
+				for (uint32_t e = 1; e < max_exponent[v]; e++, power += block)
+					for (size_t l = 0; l < block; l++)
+						power[block + l] = power[l] * x[l];
+			}
+			for (size_t l = 0; l < block; l++)
+				sums[l] = constant;
+			for (const auto &step : steps)
+			{
+				value_t *node = &path[static_cast<size_t>(step.depth) * block];
+				const value_t *power = &table[static_cast<size_t>(step.power) * block];
+				if (step.depth == 1)
+					std::copy(power, power + block, node);
+				else
+				{
+					const value_t *parent = node - block;
+					for (size_t l = 0; l < block; l++)
+						node[l] = parent[l] * power[l];
+				}
+				if (step.monomial >= 0)
+				{
+					const value_t coeff = coefficients[step.monomial];
+					for (size_t l = 0; l < block; l++)
+						sums[l] += coeff * node[l];
+				}
+			}
+			std::copy(sums, sums + lanes, results + start);
+		}
+	}
+
+	template <typename value_t>
+	std::vector<value_t> EvaluationPlan<value_t>::evaluate(const std::vector<std::vector<value_t>> &variables) const
+	{
+		const size_t count = variables.empty() ? 0 : variables[0].size();
+		std::vector<value_t> points;
+		points.reserve(count * this->variables);
+		for (int v = 0; v < this->variables; v++)
+			points.insert(points.end(), variables[v].begin(), variables[v].end());
+		std::vector<value_t> results(count);
+		evaluate(points.data(), count, results.data());
+		return results;
+	}
+}
@@ -7,15 +7,70 @@
 namespace symmp
 {
 
-	///	@brief	Hashing algorithm using CRC32 (SSE4.1 and up)
+	namespace implementation_details
+	{
+		///CRC32C of the 8 bytes of \p value (least significant first), continuing from \p crc; used when there is no CRC32 instruction
+		inline uint32_t crc32c_table(uint32_t crc, uint64_t value)
+		{
+			static const auto table = []() {
+				std::array<uint32_t, 256> table{};
+				for (uint32_t i = 0; i < 256; i++)
+				{
+					uint32_t entry = i;
+					for (int bit = 0; bit < 8; bit++)
+						entry = (entry >> 1) ^ (0x82f63b78 & (0 - (entry & 1)));
+					table[i] = entry;
+				}
+				return table;
+			}();
+			for (int byte = 0; byte < 8; byte++, value >>= 8)
+				crc = table[(crc ^ value) & 0xff] ^ (crc >> 8);
+			return crc;
+		}
+
+		///The 128 bit product of \p a and \p b: returns the low half and stores the high half in \p high
+		inline uint64_t multiply_wide(uint64_t a, uint64_t b, uint64_t &high)
+		{
+#if defined(__SIZEOF_INT128__)
+			__extension__ const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+			high = static_cast<uint64_t>(product >> 64);
+			return static_cast<uint64_t>(product);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			return _umul128(a, b, &high);
+#else
+			const uint64_t a_low = a & 0xffffffff, a_high = a >> 32, b_low = b & 0xffffffff, b_high = b >> 32;
+			const uint64_t low_low = a_low * b_low, low_high = a_low * b_high, high_low = a_high * b_low, high_high = a_high * b_high;
+			const uint64_t middle = (low_low >> 32) + (low_high & 0xffffffff) + (high_low & 0xffffffff);
+			high = high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+			return (middle << 32) | (low_low & 0xffffffff);
+#endif
+		}
+
+		///The 128 bit product of \p a and \p b with the two halves xor'ed together
+		inline uint64_t folded_multiply(uint64_t a, uint64_t b)
+		{
+			uint64_t high;
+			const uint64_t low = multiply_wide(a, b, high);
+			return low ^ high;
+		}
+	}
+
+	///	@brief	Hashing algorithm using CRC32C
 	struct crc
 	{
 		static size_t initialize() { return 0; }
 		template <typename T>
 		static void combine(size_t &hash, T value)
 		{
-			hash = _mm_crc32_u64(hash, value);
+#if defined(SYMMP_CRC32_X86)
+			hash = _mm_crc32_u64(hash, static_cast<uint64_t>(value));
+#elif defined(SYMMP_CRC32_ARM)
+			hash = __crc32cd(static_cast<uint32_t>(hash), static_cast<uint64_t>(value));
+#else
+			hash = implementation_details::crc32c_table(static_cast<uint32_t>(hash), static_cast<uint64_t>(value));
+#endif
 		}
+		static size_t finalize(size_t hash) { return hash; }
 	};
 
 	///	@brief	Hashing algorithm imitating boost_combine (golden ratio based)
@@ -29,6 +84,20 @@ namespace symmp
 		{
 			hash ^= value + golden_ratio + (hash << 6) + (hash >> 2);
 		}
+		static size_t finalize(size_t hash) { return hash; }
+	};
+
+	///	@brief	Hashing algorithm in the style of wyhash (the constants are those of wyhash)
+	struct wy_hash
+	{
+		static constexpr uint64_t secret[3] = {0xa0761d6478bd642f, 0xe7037ed1a0b428db, 0x8ebc6af09c88c6e3};
+		static size_t initialize() { return secret[0]; }
+		template <typename T>
+		static void combine(size_t &hash, T value)
+		{
+			hash = implementation_details::folded_multiply(static_cast<uint64_t>(value) ^ secret[1], hash ^ secret[2]);
+		}
+		static size_t finalize(size_t hash) { return hash; }
 	};
 
 	template <typename T, typename hasher>
@@ -37,7 +106,7 @@ namespace symmp
 		auto hash = hasher::initialize();
 		for (const auto i : v)
 			hasher::combine(hash, i);
-		return hash;
+		return hasher::finalize(hash);
 	}
 
 	template <typename R, typename T, typename S>
@@ -38,23 +38,55 @@ namespace symmp
 	}
 
 	template <typename T>
-	PermutationGenerator<T>::PermutationGenerator(T n) : n(n) {}
-
-	template <typename T>
-	size_t PermutationGenerator<T>::size() const
+	PermutationGenerator<T>::PermutationGenerator(T n) : n(n), first(0)
 	{
 		size_t factorial = 1;
 		for (int i = 2; i <= n; i++)
 		{
 			factorial *= i;
 		}
-		return factorial;
+		last = factorial;
+	}
+
+	template <typename T>
+	size_t PermutationGenerator<T>::size() const
+	{
+		return last - first;
+	}
+
+	template <typename T>
+	std::vector<T> PermutationGenerator<T>::unrank(size_t rank) const
+	{
+		std::vector<T> letters(n), permutation;
+		std::iota(letters.begin(), letters.end(), 0);
+		permutation.reserve(n);
+		std::vector<size_t> factorials(n + 1, 1);
+		for (int i = 1; i <= n; i++)
+			factorials[i] = factorials[i - 1] * i;
+		for (int i = n - 1; i >= 0; i--)
+		{ //the i-th digit of the rank in the factorial number system picks one of the remaining letters
+			const auto digit = rank / factorials[i];
+			rank %= factorials[i];
+			permutation.push_back(letters[digit]);
+			letters.erase(letters.begin() + digit);
+		}
+		return permutation;
+	}
+
+	template <typename T>
+	PermutationGenerator<T> PermutationGenerator<T>::slice(size_t from, size_t to) const
+	{
+		PermutationGenerator sliced(*this);
+		const size_t lo = std::min(from, size());
+		sliced.first = first + lo;
+		sliced.last = first + std::clamp(to, lo, size());
+		return sliced;
 	}
 
 	template <typename T>
 	void PermutationGenerator<T>::ConstIterator::update()
 	{
-		if (!std::next_permutation(this->generated.begin(), this->generated.end()))
+		if (--remaining == 0 || !std::next_permutation(this->generated.begin(), this->generated.end()))
 			this->completed = 1;
 	}
 
@@ -62,9 +94,10 @@ namespace symmp
 	typename PermutationGenerator<T>::ConstIterator PermutationGenerator<T>::begin() const
 	{
 		ConstIterator it;
-		it.generated.resize(n);
-		std::iota(it.generated.begin(), it.generated.end(), 0);
-		it.completed = 0;
+		it.remaining = size();
+		it.completed = (it.remaining == 0);
+		if (!it.completed)
+			it.generated = unrank(first);
 		return it;
 	}
 
@@ -75,32 +108,70 @@ namespace symmp
 	}
 
 	template <typename T>
-	CombinationGenerator<T>::CombinationGenerator(T total, T choices) : total(total), choices(choices)
+	CombinationGenerator<T>::CombinationGenerator(T total, T choices) : total(total), choices(choices), first(0)
 	{
 		if (choices > total)
 		{
 			std::cerr << "You can't choose more elements than those existing!";
 			abort();
 		}
+		last = binomial(total, choices);
 	}
 
 	template <typename T>
-	auto CombinationGenerator<T>::size() const
+	size_t CombinationGenerator<T>::binomial(size_t n, size_t k)
 	{
-		//safe implementation
-		auto lowchoices = (choices > total - choices) ? total - choices : choices;
-		auto binom = total;
-		for (int i = 1; i <= lowchoices - 1; i++)
-		{ // n/1 * (n-1)/2 * \cdots (n-k+1)/k
-			binom *= (total - i);
-			binom /= i + 1;
+		if (k > n)
+			return 0;
+		k = std::min(k, n - k);
+		size_t binom = 1;
+		for (size_t i = 1; i <= k; i++)
+		{ // n/1 * (n-1)/2 * \cdots (n-k+1)/k, exact at every step
+			binom *= n - k + i;
+			binom /= i;
 		}
 		return binom;
 	}
 
+	template <typename T>
+	size_t CombinationGenerator<T>::size() const
+	{
+		return last - first;
+	}
+
+	template <typename T>
+	std::vector<T> CombinationGenerator<T>::unrank(size_t rank) const
+	{
+		std::vector<T> combination;
+		combination.reserve(choices);
+		size_t letter = 0;
+		for (size_t i = 0; i < size_t(choices); i++, letter++)
+		{ //skip all combinations starting with a smaller letter
+			for (size_t skipped; (skipped = binomial(total - letter - 1, choices - i - 1)) <= rank; letter++)
+				rank -= skipped;
+			combination.push_back(letter);
+		}
+		return combination;
+	}
+
+	template <typename T>
+	CombinationGenerator<T> CombinationGenerator<T>::slice(size_t from, size_t to) const
+	{
+		CombinationGenerator sliced(*this);
+		const size_t lo = std::min(from, size());
+		sliced.first = first + lo;
+		sliced.last = first + std::clamp(to, lo, size());
+		return sliced;
+	}
+
 	template <typename T>
 	void CombinationGenerator<T>::ConstIterator::update()
 	{
+		if (--remaining == 0)
+		{
+			this->completed = 1;
+			return;
+		}
 		for (int64_t i = (int64_t)choices - 1; i >= 0; i--)
 		{ //must be signed!
 			if (this->generated[i] < total - choices + i)
@@ -119,11 +190,12 @@ namespace symmp
 	typename CombinationGenerator<T>::ConstIterator CombinationGenerator<T>::begin() const
 	{
 		ConstIterator it;
-		it.generated.resize(choices);
-		std::iota(it.generated.begin(), it.generated.end(), 0);
 		it.total = total;
 		it.choices = choices;
-		it.completed = 0;
+		it.remaining = size();
+		it.completed = (it.remaining == 0);
+		if (!it.completed)
+			it.generated = unrank(first);
 		return it;
 	}
 
@@ -7,20 +7,6 @@
 namespace symmp
 {
 
-	template <typename T, size_t N>
-	struct ArrayVectorWrapper : public std::array<T, N>
-	{
-		using std::array<T, N>::array;
-		///Constructor with "size" does nothing (used to have consistent interface with vector)
-		ArrayVectorWrapper(size_t) : std::array<T, N>() {}
-	};
-
-	template <typename T>
-	struct ArrayVectorWrapper<T, 0> : public std::vector<T>
-	{
-		using std::vector<T>::vector;
-	};
-
 	template <typename T, typename _deg, size_t N>
 	_deg HalfIdempotentVariables<T, _deg, N>::degree() const
 	{
@@ -34,21 +20,31 @@ namespace symmp
 	HalfIdempotentVariables<T, _deg, N> HalfIdempotentVariables<T, _deg, N>::operator+(const HalfIdempotentVariables &other) const
 	{
 		HalfIdempotentVariables v(this->size());
-		for (size_t i = 0; i < this->size(); i++)
+		for (size_t i = 0; i < this->size() / 2; i++)
 			v[i] = (*this)[i] + other[i];
 		for (size_t i = this->size() / 2; i < this->size(); i++)
-			v[i] = (v[i] > 0);
+			v[i] = std::max((*this)[i], other[i]); //the y_i exponents are 0 or 1
 		return v;
 	}
 
+	template <typename T, typename _deg, size_t N>
+	HalfIdempotentVariables<T, _deg, N> &HalfIdempotentVariables<T, _deg, N>::operator+=(const HalfIdempotentVariables &other)
+	{
+		for (size_t i = 0; i < this->size() / 2; i++)
+			(*this)[i] += other[i];
+		for (size_t i = this->size() / 2; i < this->size(); i++)
+			(*this)[i] = std::max((*this)[i], other[i]); //the y_i exponents are 0 or 1
+		return *this;
+	}
+
 	template <typename T, typename _deg, size_t N>
 	HalfIdempotentVariables<T, _deg, N> HalfIdempotentVariables<T, _deg, N>::operator-(const HalfIdempotentVariables &other) const
 	{
 		HalfIdempotentVariables v(this->size());
-		for (size_t i = 0; i < this->size(); i++)
+		for (size_t i = 0; i < this->size() / 2; i++)
 			v[i] = (*this)[i] - other[i];
 		for (size_t i = this->size() / 2; i < this->size(); i++)
-			v[i] = (v[i] > 0);
+			v[i] = ((*this)[i] != other[i]); //the y_i exponents are 0 or 1
 		return v;
 	}
 
@@ -67,92 +63,311 @@ namespace symmp
 		return generic_hasher(*this);
 	}
 
-	template <typename T, typename _deg>
-	TwistedChernVariables<T, _deg> TwistedChernVariables<T, _deg>::operator+(const TwistedChernVariables &other) const
+	template <typename T, typename _deg, size_t N>
+	TwistedChernVariables<T, _deg, N> TwistedChernVariables<T, _deg, N>::operator+(const TwistedChernVariables &other) const
 	{
-		StandardVariables v(*this);
+		TwistedChernVariables v(*this);
 		for (size_t i = 0; i < this->size(); i++)
 			v[i] += other[i];
 		return v;
 	}
 
-	template <typename T, typename _deg>
-	size_t TwistedChernVariables<T, _deg>::operator()() const
+	template <typename T, typename _deg, size_t N>
+	TwistedChernVariables<T, _deg, N> &TwistedChernVariables<T, _deg, N>::operator+=(const TwistedChernVariables &other)
+	{
+		for (size_t i = 0; i < this->size(); i++)
+			(*this)[i] += other[i];
+		return *this;
+	}
+
+	template <typename T, typename _deg, size_t N>
+	size_t TwistedChernVariables<T, _deg, N>::operator()() const
 	{
 		return generic_hasher(*this);
 	}
 
 	template <typename xy, typename ch>
-	TwistedChernBasis<xy, ch>::TwistedChernBasis(int n) : PolynomialBasis<TwistedChernBasis<xy, ch>, xy, ch>(2 * n), n(n), number_of_generators(n + (n * n + n) / 2)
+	TwistedChernBasis<xy, ch>::TwistedChernBasis(int n, bool lazy) : PolynomialBasis<TwistedChernBasis<xy, ch>, xy, ch>(2 * n), n(n), generator_count(n + (n * n + n) / 2)
 	{
-		set_generators();
-		set_relations();
+		constexpr size_t chern_size = implementation_details::static_size<chern_t>::value;
+		if ((fixed_n != 0 && fixed_n != n) || (chern_size != 0 && chern_size != size_t(generator_count)))
+		{
+			std::cerr << "n must match the compile-time size of the exponents: 2n for the x_i,y_i and n+n(n+1)/2 for the c_{s,j}";
+			abort();
+		}
+		set_generators(lazy);
 	}
 
 	template <typename xy, typename ch>
-	const std::vector<ch> &TwistedChernBasis<xy, ch>::relations() const
+	auto TwistedChernBasis<xy, ch>::relations() const -> RelationRange
 	{
-		return _relations;
+		return RelationRange(this);
 	}
 
 	template <typename xy, typename ch>
-	const xy &TwistedChernBasis<xy, ch>::generator(int s, int j) const
+	TwistedChernBasis<xy, ch>::RelationRange::RelationRange(const TwistedChernBasis *basis) : basis(basis) {}
+
+	template <typename xy, typename ch>
+	auto TwistedChernBasis<xy, ch>::RelationRange::begin() const -> ConstIterator
 	{
-		return _generators[index(s, j)];
+		return ConstIterator(basis, 0);
 	}
 
 	template <typename xy, typename ch>
-	int TwistedChernBasis<xy, ch>::index(int s, int j) const
+	auto TwistedChernBasis<xy, ch>::RelationRange::end() const -> ConstIterator
+	{
+		return ConstIterator(basis, basis->n);
+	}
+
+	template <typename xy, typename ch>
+	size_t TwistedChernBasis<xy, ch>::RelationRange::size() const
+	{
+		size_t count = 0;
+		for (auto it = begin(); it != end(); ++it)
+			count++;
+		return count;
+	}
+
+	template <typename xy, typename ch>
+	TwistedChernBasis<xy, ch>::RelationRange::ConstIterator::ConstIterator(const TwistedChernBasis *basis, int s) : basis(basis), s(s), t(s), i(1), j(1)
+	{
+		while (this->s < basis->n && !is_relation())
+			advance();
+	}
+
+	template <typename xy, typename ch>
+	bool TwistedChernBasis<xy, ch>::RelationRange::ConstIterator::is_relation() const
+	{
+		//if t>s+i no relation, if s==t && j<i we have a symmetric relation, if s==0 && t!=i we can get if from the relation between a_j and a_1
+		return !(t > s + i || (s == t && j < i) || (s == 0 && t != i));
+	}
+
+	template <typename xy, typename ch>
+	void TwistedChernBasis<xy, ch>::RelationRange::ConstIterator::advance()
+	{
+		const int n = basis->n;
+		if (++j <= n - t)
+			return;
+		j = 1;
+		if (++i <= n - s)
+			return;
+		i = 1;
+		if (++t < n)
+			return;
+		t = ++s;
+	}
+
+	template <typename xy, typename ch>
+	auto TwistedChernBasis<xy, ch>::RelationRange::ConstIterator::operator++() -> ConstIterator &
 	{
-		return generator_double_index.at({s, j});
+		do
+			advance();
+		while (s < basis->n && !is_relation());
+		return *this;
 	}
 
 	template <typename xy, typename ch>
-	auto TwistedChernBasis<xy, ch>::create_generator(int s, int i)
+	bool TwistedChernBasis<xy, ch>::RelationRange::ConstIterator::operator!=(const ConstIterator &other) const
 	{
-		xy tchern;
-		xy_t mono(2 * n);
-		auto c_x = CombinationGenerator<typename xy_t::value_type>(n, s);
-		auto c_y = CombinationGenerator<typename xy_t::value_type>(n - s, i);
-		for (const auto &comb_x : c_x)
+		return s != other.s || t != other.t || i != other.i || j != other.j;
+	}
+
+	template <typename xy, typename ch>
+	ch TwistedChernBasis<xy, ch>::RelationRange::ConstIterator::operator*() const
+	{
+		chern_t comb(basis->generator_count);
+		comb[basis->index(s, i)]++;
+		comb[basis->index(t, j)]++;
+		return ch(comb, 1, basis->generator_dimensions.data(), basis->generator_names.data());
+	}
+
+	template <typename xy, typename ch>
+	const xy &TwistedChernBasis<xy, ch>::generator(int s, int j) const
+	{
+		return generator(size_t(index(s, j)));
+	}
+
+	template <typename xy, typename ch>
+	template <class poly_t>
+	std::vector<size_t> TwistedChernBasis<xy, ch>::probable_mismatches(const std::vector<ch> &a, const std::vector<poly_t> &b, int rounds, uint64_t seed, int threads) const
+	{
+		static_assert(std::is_same_v<poly_t, xy> || std::is_same_v<poly_t, ch>, "The polynomials must be on the x_i,y_i or on the c_{s,j}");
+		typedef ModularInteger<modular_primes[0]> mod_t;
+		if (a.size() != b.size())
 		{
-			for (const auto &j : comb_x)
-				mono[j] = 1;
-			std::vector<typename xy_t::value_type> letters_not_in_comb_x;
-			letters_not_in_comb_x.reserve(n - s);
-			for (int j = 0; j < n; j++)
+			std::cerr << "probable_mismatches needs as many polynomials on either side";
+			abort();
+		}
+		//the points, in structure-of-arrays layout: random x_i, and y_1=...=y_k=1, y_{k+1}=...=y_n=0 for every 0<=k<=n
+		const size_t points = static_cast<size_t>(rounds) * (n + 1);
+		std::mt19937_64 random(seed);
+		std::uniform_int_distribution<uint64_t> residue(0, mod_t::modulus - 1);
+		std::vector<mod_t> xy_values(2 * n * points);
+		for (size_t round = 0; round < points; round += n + 1)
+			for (int i = 0; i < n; i++)
 			{
-				if (std::find(comb_x.begin(), comb_x.end(), j) == comb_x.end())
-					letters_not_in_comb_x.push_back(j);
+				const mod_t x = residue(random);
+				for (int k = 0; k <= n; k++)
+				{
+					xy_values[i * points + round + k] = x;
+					xy_values[(n + i) * points + round + k] = (i < k);
+				}
 			}
-			for (const auto &comb_y : c_y)
+		//the values of the generators at the points, which are the points of the polynomials on the c_{s,j}
+		TaskPool pool(threads);
+		std::vector<mod_t> values(generator_count * points);
+		std::vector<size_t> tasks(generator_count);
+		for (size_t i = 0; i < tasks.size(); i++)
+			tasks[i] = i;
+		pool.run(tasks, [&](size_t i, int) { EvaluationPlan<mod_t>(generator(i), 2 * n).evaluate(xy_values.data(), points, &values[i * points]); });
+		std::vector<char> mismatch(a.size(), 0);
+		tasks.resize(a.size());
+		for (size_t i = 0; i < tasks.size(); i++)
+			tasks[i] = i;
+		pool.run(tasks, [&](size_t i, int) {
+			std::vector<mod_t> left(points), right(points);
+			EvaluationPlan<mod_t>(a[i], generator_count).evaluate(values.data(), points, left.data());
+			if constexpr (std::is_same_v<poly_t, xy>)
+				EvaluationPlan<mod_t>(b[i], 2 * n).evaluate(xy_values.data(), points, right.data());
+			else
+				EvaluationPlan<mod_t>(b[i], generator_count).evaluate(values.data(), points, right.data());
+			mismatch[i] = left != right;
+		});
+		std::vector<size_t> mismatches;
+		for (size_t i = 0; i < a.size(); i++)
+			if (mismatch[i])
+				mismatches.push_back(i);
+		return mismatches;
+	}
+
+	template <typename xy, typename ch>
+	std::vector<size_t> TwistedChernBasis<xy, ch>::relation_shard(size_t shard, size_t shards, bool balanced) const
+	{
+		if (shard >= shards)
+		{
+			std::cerr << "The shard must be less than the number of shards";
+			abort();
+		}
+		std::vector<size_t> indices;
+		if (!balanced)
+		{
+			const size_t count = relations().size();
+			for (size_t k = shard; k < count; k += shards)
+				indices.push_back(k);
+			return indices;
+		}
+		//each relation is a monomial on the c_{s,j} whose expansion multiplies the generators; as in run_batch, the decomposition also scales with the degree
+		std::vector<uint64_t> cost;
+		for (const auto &relation : relations())
+		{
+			const auto &exponent = relation.begin().exponent();
+			uint64_t products = 1;
+			for (size_t k = 0; k < exponent.size(); k++)
+				for (int e = 0; e < exponent[k]; e++)
+					products *= generator(k).number_of_monomials();
+			cost.push_back(products * (relation.begin().degree() + 1));
+		}
+		std::vector<size_t> order(cost.size());
+		for (size_t k = 0; k < order.size(); k++)
+			order[k] = k;
+		std::stable_sort(order.begin(), order.end(), [&](size_t k, size_t l) { return cost[k] > cost[l]; });
+		//ties go to the first shard, so the partition is the same in every process
+		std::vector<uint64_t> load(shards, 0);
+		for (size_t k : order)
+		{
+			const size_t target = std::min_element(load.begin(), load.end()) - load.begin();
+			load[target] += cost[k];
+			if (target == shard)
+				indices.push_back(k);
+		}
+		std::sort(indices.begin(), indices.end());
+		return indices;
+	}
+
+	template <typename xy, typename ch>
+	int TwistedChernBasis<xy, ch>::half() const
+	{
+		if constexpr (fixed_n != 0)
+			return fixed_n;
+		else
+			return n;
+	}
+
+	template <typename xy, typename ch>
+	constexpr int TwistedChernBasis<xy, ch>::index(int n, int s, int j)
+	{
+		//c_{s',j'} with s'<s come first: n+1-s' of them for each s', minus the missing c_{0,0}
+		return s * (n + 1) - s * (s - 1) / 2 + j - 1;
+	}
+
+	template <typename xy, typename ch>
+	int TwistedChernBasis<xy, ch>::index(int s, int j) const
+	{
+		return index(half(), s, j);
+	}
+
+	template <typename xy, typename ch>
+	xy TwistedChernBasis<xy, ch>::create_generator(int s, int i) const
+	{
+		const auto c_x = CombinationGenerator<typename xy_t::value_type>(n, s);
+		const auto c_y = CombinationGenerator<typename xy_t::value_type>(n - s, i);
+		return this->build_in_parallel(c_x.size(), c_y.size(), [&](size_t first, size_t last) {
+			typename TwistedChernBasis::terms_t terms;
+			terms.reserve((last - first) * c_y.size());
+			xy_t mono(2 * n);
+			std::vector<typename xy_t::value_type> letters_not_in_comb_x(n - s);
+			std::vector<bool> in_comb_x(n);
+			for (const auto &comb_x : c_x.slice(first, last))
 			{
-				for (const auto &j : comb_y)
-					mono[n + letters_not_in_comb_x[j]] = 1;
-				tchern.insert(mono, 1);
-				for (const auto &j : comb_y)
-					mono[n + letters_not_in_comb_x[j]] = 0;
+				for (const auto &j : comb_x)
+				{
+					mono[j] = 1;
+					in_comb_x[j] = 1;
+				}
+				for (int j = 0, k = 0; j < n; j++)
+					if (!in_comb_x[j])
+						letters_not_in_comb_x[k++] = j;
+				//the complement is increasing, so the y-parts come out in the same (decreasing) order as the combinations
+				for (const auto &comb_y : c_y)
+				{
+					for (const auto &j : comb_y)
+						mono[n + letters_not_in_comb_x[j]] = 1;
+					terms.emplace_back(mono, 1);
+					for (const auto &j : comb_y)
+						mono[n + letters_not_in_comb_x[j]] = 0;
+				}
+				for (const auto &j : comb_x)
+				{
+					mono[j] = 0;
+					in_comb_x[j] = 0;
+				}
 			}
-			for (const auto &j : comb_x)
-				mono[j] = 0;
-		}
-		return tchern;
+			return terms;
+		});
+	}
+
+	template <typename xy, typename ch>
+	xy TwistedChernBasis<xy, ch>::make_generator(size_t k) const
+	{
+		//invert index(s,j): there are n generators with s=0 (skipping c_{0,0}) and n+1-s for each s>0
+		int s = 0;
+		size_t j = k + 1;
+		for (; j > size_t(n - s); s++)
+			j -= n + 1 - s;
+		return create_generator(s, j);
 	}
 
 	template <typename xy, typename ch>
-	void TwistedChernBasis<xy, ch>::set_generators()
+	void TwistedChernBasis<xy, ch>::set_generators(bool lazy)
 	{
-		generator_names.reserve(number_of_generators);
-		generator_dimensions.reserve(number_of_generators);
-		_generators.reserve(number_of_generators);
-		int ind = 0;
+		generator_names.reserve(generator_count);
+		generator_dimensions.reserve(generator_count);
 		for (int s = 0; s <= n; s++)
 		{
 			for (int i = 0; i <= n - s; i++)
 			{
 				if (i == 0 && s == 0)
 					continue;
-				_generators.push_back(create_generator(s, i));
 				if (i == 0)
 					generator_names.push_back("c_" + std::to_string(s));
 				else if (s == 0)
@@ -160,115 +375,109 @@ namespace symmp
 				else
 					generator_names.push_back("c_{" + std::to_string(s) + "," + std::to_string(i) + "}");
 				generator_dimensions.push_back(s);
-				generator_double_index[{s, i}] = ind;
-				ind++;
 			}
 		}
-	}
-
-	template <typename xy, typename ch>
-	void TwistedChernBasis<xy, ch>::set_relations()
-	{
-		for (int s = 0; s < n; s++)
-			for (int t = s; t < n; t++)
-				for (int i = 1; i <= n - s; i++)
-					for (int j = 1; j <= n - t; j++)
-					{
-						if (t > s + i || (s == t && j < i) || (s == 0 && t != i)) //if t>s+i no relation, if s==t && j<i we have a symmetric relation, if s==0 && t!=i we can get if from the relation between a_j and a_1
-							continue;
-						chern_t comb(number_of_generators);
-						comb[generator_double_index[{s, i}]]++;
-						comb[generator_double_index[{t, j}]]++;
-						_relations.emplace_back(comb, 1, generator_dimensions.data(), generator_names.data());
-					}
+		this->set_number_of_generators(generator_count, lazy);
 	}
 
 	template <typename xy, typename ch>
 	auto TwistedChernBasis<xy, ch>::find_exponent(const xy_t &term) const
 	{
-		chern_t exponent(number_of_generators);
-		find_exponent_recursive(term, exponent);
-		return exponent;
-	}
-
-	template <typename xy, typename ch>
-	void TwistedChernBasis<xy, ch>::find_exponent_recursive(const xy_t &term, chern_t &exponent) const
-	{
-		if (term[n] > 0)
-		{ //clear the consecutive y_i at the start
-			int consecutive_u_at_start = 0;
-			xy_t us_at_start(2 * n);
-			for (int i = n; i < 2 * n && term[i] > 0; i++)
-			{
-				us_at_start[i] = 1;
-				consecutive_u_at_start++;
-			}
-			if (consecutive_u_at_start > 0)
-				exponent[index(0, consecutive_u_at_start)] = 1;
-			find_exponent_recursive(term - us_at_start, exponent);
-			return;
-		}
-		bool found_last_u = 0;
-		int last_consecutive_u_from_end = 2 * n;
-		int number_consecutive_u = 0;
-		for (int i = 2 * n - 1; i >= n; i--)
+		const int n = half(); //a compile-time constant for fixed-size exponents
+		chern_t exponent(generator_count);
+		//what is left after removing the c_{s,j} with j>0 is an elementary symmetric on the x_i
+		for (int i = 1; i < n; i++)
+			exponent[index(i, 0)] += term[i - 1] - term[i];
+		exponent[index(n, 0)] += term[n - 1];
+		//the consecutive y_1,...,y_j at the start give a_j
+		int start = 0;
+		while (start < n && term[n + start] > 0)
+			start++;
+		if (start > 0)
+			exponent[index(0, start)]++;
+		//every other block of consecutive y_{s+1},...,y_{s+j} gives c_{s,j}, which also uses one of each x_1,...,x_s: so one less c_s
+		for (int s = start; s < n;)
 		{
-			if (term[i] == 0 && found_last_u)
-				break;
-			else if (term[i] > 0)
+			if (term[n + s] == 0)
 			{
-				last_consecutive_u_from_end = i;
-				number_consecutive_u++;
-				found_last_u = 1;
+				s++;
+				continue;
 			}
+			int end = s;
+			while (end < n && term[n + end] > 0)
+				end++;
+			exponent[index(s, end - s)]++;
+			exponent[index(s, 0)] -= 1;
+			s = end;
 		}
-		if (last_consecutive_u_from_end == 2 * n)
-		{ //no y_i means it's an elementary symmetric on the x_i
-			for (int i = 1; i < n; i++)
-				exponent[index(i, 0)] += term[i - 1] - term[i];
-			exponent[index(n, 0)] += term[n - 1];
-			return;
-		}
-		if (last_consecutive_u_from_end > n)
-		{ //not first y_i so add c_{s,i} to the exponent
-			auto ind = index(last_consecutive_u_from_end - n, number_consecutive_u);
-			exponent[ind]++;
-			find_exponent_recursive(term - _generators[ind].highest_term().exponent(), exponent);
-		}
+		return exponent;
 	}
 
 	template <typename xy_poly_t, typename chern_poly_t>
-	void print_half_idempotent_relations(int n, bool print, bool verify, bool verify_verbose)
+	void print_half_idempotent_relations(int n, bool print, bool verify, bool verify_verbose, bool probabilistic)
 	{
 		TwistedChernBasis<xy_poly_t,chern_poly_t> tcb(n);
-SYMMP_RUN_LOOP_IN_PARALLEL
-		for (int64_t i = 0; i < (int64_t)tcb.relations().size(); i++)
-		{ //i is signed as MSVC still does not support OMP3.0...
-			const auto &rel = tcb.relations()[i];
-			auto p = tcb(rel);
-			auto q = tcb(p);
-			std::stringstream ss;
-			if (print)
-				ss << rel << " = " << q << "\n";
-			if (verify)
-			{
-				if (p != tcb(q))
+		const auto relations = tcb.relations();
+		//the relations are handled in windows, each printed and freed before the next, so only a window of expansions is ever held;
+		//a window has enough relations to keep every worker busy
+		const size_t window = 64 * static_cast<size_t>(TaskPool().threads());
+		PolynomialWriter out(std::cout); //one buffer for all relations, written out in large chunks
+		std::vector<chern_poly_t> rels;
+		for (auto it = relations.begin(); it != relations.end();)
+		{
+			rels.clear();
+			for (; it != relations.end() && rels.size() < window; ++it)
+				rels.push_back(*it);
+			const auto ps = tcb.expand_batch(rels);
+			const auto report = [&](size_t i, const chern_poly_t &q, bool wrong) {
+				if (print)
+					out << rels[i] << " = " << q << '\n';
+				if (!verify)
+					return;
+				if (wrong)
 				{
+					out.flush();
 					std::cerr << "Verification failed! Relation in x_i,y_i is:\n"
-							  << rel << "\n Relation in a,c_i,c_{s,j} is\n"
-							  << p << "\n Relation in x_i,y_i is: \n"
+							  << rels[i] << "\n Relation in a,c_i,c_{s,j} is\n"
+							  << ps[i] << "\n Relation in x_i,y_i is: \n"
 							  << q;
 					abort();
 				}
-				else
-				{
-					ss << "Relation verified! \n";
-					if (verify_verbose)
-						ss << "In x, y variables both LHS and RHS are : " << p;
-					ss << "\n\n";
-				}
+				out << "Relation verified! \n";
+				if (verify_verbose)
+					out << "In x, y variables both LHS and RHS are : " << ps[i];
+				out << "\n\n";
+			};
+			if (!verify)
+			{ //each decomposition is printed as soon as it and those before it are done, and freed right after
+				tcb.decompose_stream(ps, [&](size_t i, chern_poly_t &&q) { report(i, q, 0); });
+				out.flush();
+				continue;
+			}
+			//symbolically verify every relation, or only those that failed the probabilistic verification;
+			//each is printed as soon as its check and those before it are done, and the check is freed right after
+			const auto qs = tcb.decompose_batch(ps);
+			std::vector<size_t> checked;
+			std::vector<chern_poly_t> suspect_qs;
+			if (probabilistic)
+			{
+				checked = tcb.probable_mismatches(rels, qs);
+				for (size_t i : checked)
+					suspect_qs.push_back(qs[i]);
 			}
-			std::cout << ss.str();
+			else
+				for (size_t i = 0; i < qs.size(); i++)
+					checked.push_back(i);
+			size_t printed = 0;
+			tcb.expand_stream(probabilistic ? suspect_qs : qs, [&](size_t k, xy_poly_t &&check) {
+				for (; printed < checked[k]; printed++) //passed the probabilistic verification
+					report(printed, qs[printed], 0);
+				report(printed, qs[printed], check != ps[printed]);
+				printed++;
+			});
+			for (; printed < qs.size(); printed++)
+				report(printed, qs[printed], 0);
+			out.flush();
 		}
 	}
 
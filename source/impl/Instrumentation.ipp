@@ -0,0 +1,161 @@
+#pragma once
+#include "../Instrumentation.hpp"
+
+///@file
+///@brief Implementation of Instrumentation.hpp
+
+namespace symmp
+{
+	namespace implementation_details
+	{
+		///The instrumentation of the running threads, and the counts of the exited ones
+		struct InstrumentationRegistry
+		{
+			std::mutex mutex;
+			std::vector<ThreadInstrumentation *> threads;
+			InstrumentationReport exited;
+		};
+
+		inline InstrumentationRegistry &instrumentation_registry()
+		{
+			static InstrumentationRegistry registry;
+			return registry;
+		}
+
+		//only the owning thread writes, so a relaxed load and store suffice (no locked instruction)
+		inline void instrument_add(std::atomic<uint64_t> &value, uint64_t amount)
+		{
+			value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+
+		inline ThreadInstrumentation::ThreadInstrumentation()
+		{
+			reset();
+			auto &registry = instrumentation_registry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.threads.push_back(this);
+		}
+
+		inline ThreadInstrumentation::~ThreadInstrumentation()
+		{
+			auto &registry = instrumentation_registry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			add_to(registry.exited);
+			registry.exited.threads++;
+			registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+		}
+
+		inline void ThreadInstrumentation::add_to(InstrumentationReport &report) const
+		{
+			for (size_t i = 0; i < instrumented_counters; i++)
+				report.counters[i] += counters[i].load(std::memory_order_relaxed);
+			for (size_t i = 0; i < instrumented_phases; i++)
+			{
+				report.phase_calls[i] += phase_calls[i].load(std::memory_order_relaxed);
+				report.phase_nanoseconds[i] += phase_nanoseconds[i].load(std::memory_order_relaxed);
+			}
+			report.largest_peak_monomials = std::max(report.largest_peak_monomials, largest_peak_monomials.load(std::memory_order_relaxed));
+		}
+
+		inline void ThreadInstrumentation::reset()
+		{
+			for (auto &value : counters)
+				value.store(0, std::memory_order_relaxed);
+			for (size_t i = 0; i < instrumented_phases; i++)
+			{
+				phase_calls[i].store(0, std::memory_order_relaxed);
+				phase_nanoseconds[i].store(0, std::memory_order_relaxed);
+			}
+			largest_peak_monomials.store(0, std::memory_order_relaxed);
+		}
+
+		inline ThreadInstrumentation &thread_instrumentation()
+		{
+			instrumentation_registry(); //constructed first, so destroyed after the instrumentation of the main thread
+			thread_local ThreadInstrumentation instrumentation;
+			return instrumentation;
+		}
+
+		inline void instrument_count(InstrumentedCounter counter, uint64_t amount)
+		{
+			instrument_add(thread_instrumentation().counters[static_cast<size_t>(counter)], amount);
+		}
+
+		inline void instrument_peak(uint64_t monomials)
+		{
+			auto &instrumentation = thread_instrumentation();
+			instrument_add(instrumentation.counters[static_cast<size_t>(InstrumentedCounter::peak_monomials)], monomials);
+			if (monomials > instrumentation.largest_peak_monomials.load(std::memory_order_relaxed))
+				instrumentation.largest_peak_monomials.store(monomials, std::memory_order_relaxed);
+		}
+
+		inline PhaseTimer::PhaseTimer(InstrumentedPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+
+		inline PhaseTimer::~PhaseTimer()
+		{
+			const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			auto &instrumentation = thread_instrumentation();
+			instrument_add(instrumentation.phase_calls[static_cast<size_t>(phase)], 1);
+			instrument_add(instrumentation.phase_nanoseconds[static_cast<size_t>(phase)], static_cast<uint64_t>(nanoseconds));
+		}
+	}
+
+	inline uint64_t InstrumentationReport::operator[](InstrumentedCounter counter) const
+	{
+		return counters[static_cast<size_t>(counter)];
+	}
+
+	inline double InstrumentationReport::seconds(InstrumentedPhase phase) const
+	{
+		return phase_nanoseconds[static_cast<size_t>(phase)] * 1e-9;
+	}
+
+	inline const char *instrumentation_name(InstrumentedCounter counter)
+	{
+		constexpr const char *names[instrumented_counters] = {"decompositions", "expansions", "reduction_iterations", "product_terms", "cancelled_terms", "rehashes", "peak_monomials"};
+		return names[static_cast<size_t>(counter)];
+	}
+
+	inline const char *instrumentation_name(InstrumentedPhase phase)
+	{
+		constexpr const char *names[instrumented_phases] = {"highest_term", "find_exponent", "compute_product", "subtract", "add"};
+		return names[static_cast<size_t>(phase)];
+	}
+
+	inline InstrumentationReport instrumentation_report()
+	{
+		auto &registry = implementation_details::instrumentation_registry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		InstrumentationReport report = registry.exited;
+		for (const auto *thread : registry.threads)
+			thread->add_to(report);
+		report.threads += registry.threads.size();
+		return report;
+	}
+
+	inline void reset_instrumentation()
+	{
+		auto &registry = implementation_details::instrumentation_registry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.exited = InstrumentationReport();
+		for (auto *thread : registry.threads)
+			thread->reset();
+	}
+
+	inline std::ostream &operator<<(std::ostream &os, const InstrumentationReport &report)
+	{
+		os << "threads: " << report.threads << "\n";
+		for (size_t i = 0; i < instrumented_counters; i++)
+			os << instrumentation_name(static_cast<InstrumentedCounter>(i)) << ": " << report.counters[i] << "\n";
+		os << "largest_peak_monomials: " << report.largest_peak_monomials << "\n";
+		for (size_t i = 0; i < instrumented_phases; i++)
+		{
+			const auto calls = report.phase_calls[i];
+			os << instrumentation_name(static_cast<InstrumentedPhase>(i)) << ": " << calls << " calls, " << report.phase_nanoseconds[i] * 1e-9 << " s";
+			if (calls != 0)
+				os << ", " << static_cast<double>(report.phase_nanoseconds[i]) / calls << " ns/call";
+			os << "\n";
+		}
+		return os;
+	}
+}
@@ -0,0 +1,479 @@
+#pragma once
+#include "../Monomial_Map.hpp"
+
+///	@file
+///	@brief Implementation of Monomial_Map.hpp
+
+namespace symmp
+{
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	MonomialMap<K, V, hash_t, equal_t, alloc_t>::MonomialMap() : MonomialMap(alloc_t()) {}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	MonomialMap<K, V, hash_t, equal_t, alloc_t>::MonomialMap(const alloc_t &alloc)
+		: slot_alloc(alloc), metadata_alloc(alloc), slots(nullptr), metadata(nullptr), slots_count(0), entries(0), shift(32) {}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	MonomialMap<K, V, hash_t, equal_t, alloc_t>::MonomialMap(const MonomialMap &other)
+		: slot_alloc(slot_traits::select_on_container_copy_construction(other.slot_alloc)),
+		  metadata_alloc(metadata_traits::select_on_container_copy_construction(other.metadata_alloc)),
+		  slots(nullptr), metadata(nullptr), slots_count(0), entries(0), shift(32)
+	{
+		copy_entries(other);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	MonomialMap<K, V, hash_t, equal_t, alloc_t>::MonomialMap(MonomialMap &&other) noexcept
+		: slot_alloc(std::move(other.slot_alloc)), metadata_alloc(std::move(other.metadata_alloc)),
+		  slots(nullptr), metadata(nullptr), slots_count(0), entries(0), shift(32)
+	{
+		steal(other);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::operator=(const MonomialMap &other) -> MonomialMap &
+	{
+		if (this == &other)
+			return *this;
+		clear();
+		if constexpr (slot_traits::propagate_on_container_copy_assignment::value)
+		{
+			deallocate();
+			slot_alloc = other.slot_alloc;
+			metadata_alloc = other.metadata_alloc;
+		}
+		copy_entries(other);
+		return *this;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::operator=(MonomialMap &&other) noexcept(std::allocator_traits<alloc_t>::propagate_on_container_move_assignment::value) -> MonomialMap &
+	{
+		if (this == &other)
+			return *this;
+		clear();
+		if constexpr (slot_traits::propagate_on_container_move_assignment::value)
+		{
+			deallocate();
+			slot_alloc = std::move(other.slot_alloc);
+			metadata_alloc = std::move(other.metadata_alloc);
+			steal(other);
+		}
+		else if (slot_alloc == other.slot_alloc)
+		{
+			deallocate();
+			steal(other);
+		}
+		else
+		{ //different memory resources: the entries have to be moved one by one
+			reserve(other.size());
+			for (auto &entry : other)
+				try_emplace(std::move(entry.first), std::move(entry.second));
+			other.clear();
+		}
+		return *this;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	MonomialMap<K, V, hash_t, equal_t, alloc_t>::~MonomialMap()
+	{
+		destroy_entries();
+		deallocate();
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::size() const
+	{
+		return entries;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	bool MonomialMap<K, V, hash_t, equal_t, alloc_t>::empty() const
+	{
+		return entries == 0;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::capacity() const
+	{
+		return slots_count;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::allocated_bytes() const
+	{
+		return slots_count * (sizeof(value_type) + sizeof(Metadata));
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::reserve(size_t n)
+	{
+		const size_t needed = slots_needed(std::max(n, entries));
+		//iterating scans all slots, so a table that has mostly cancelled out is shrunk here rather than on every erase,
+		//where a subtraction would shrink step by step the table it has just grown
+		if (needed > slots_count || needed * 8 < slots_count)
+			rehash(needed);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::clear()
+	{
+		destroy_entries();
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::begin() -> iterator
+	{
+		return ++iterator(this, size_t(-1));
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::end() -> iterator
+	{
+		return iterator(this, slots_count);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::begin() const -> const_iterator
+	{
+		return ++const_iterator(this, size_t(-1));
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::end() const -> const_iterator
+	{
+		return const_iterator(this, slots_count);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::find(const K &key) -> iterator
+	{
+		return iterator(this, probe(key, fragment(hash_t()(key))));
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::find(const K &key) const -> const_iterator
+	{
+		return const_iterator(this, probe(key, fragment(hash_t()(key))));
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <class key_arg, class... Args>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::try_emplace(key_arg &&key, Args &&...args) -> std::pair<iterator, bool>
+	{
+		const uint32_t f = fragment(hash_t()(key));
+		size_t i = 0;
+		uint32_t d = 1;
+		if (slots_count != 0)
+		{
+			for (i = home(f); metadata[i].distance >= d; i = (i + 1) & (slots_count - 1), d++)
+				if (metadata[i].distance == d && metadata[i].fragment == f && equal_t()(slots[i].first, key))
+					return {iterator(this, i), false};
+		}
+		//constructed before any entry is moved, so that an exception leaves the table intact
+		value_type entry(std::piecewise_construct, std::forward_as_tuple(std::forward<key_arg>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		if ((entries + 1) * 5 > slots_count * 4)
+		{ //keep the load factor at most 4/5
+			rehash(slots_needed(entries + 1));
+			i = place(f);
+		}
+		else
+			i = place(f, i, d);
+		slot_traits::construct(slot_alloc, slots + i, std::move(entry));
+		entries++;
+		return {iterator(this, i), true};
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <class key_arg, class... Args>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::emplace(key_arg &&key, Args &&...args) -> std::pair<iterator, bool>
+	{
+		return try_emplace(std::forward<key_arg>(key), std::forward<Args>(args)...);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::erase(const_iterator it)
+	{
+		//shift the rest of the cluster back by one slot: no tombstones
+		size_t i = it.slot;
+		slot_traits::destroy(slot_alloc, slots + i);
+		for (size_t j = (i + 1) & (slots_count - 1); metadata[j].distance > 1; i = j, j = (j + 1) & (slots_count - 1))
+		{
+			slot_traits::construct(slot_alloc, slots + i, std::move(slots[j]));
+			slot_traits::destroy(slot_alloc, slots + j);
+			metadata[i] = {metadata[j].distance - 1, metadata[j].fragment};
+		}
+		metadata[i].distance = 0;
+		entries--;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::erase(const K &key)
+	{
+		const auto it = find(key);
+		if (it == end())
+			return 0;
+		erase(it);
+		return 1;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	bool MonomialMap<K, V, hash_t, equal_t, alloc_t>::operator==(const MonomialMap &other) const
+	{
+		if (entries != other.entries)
+			return 0;
+		for (const auto &entry : *this)
+		{
+			const auto it = other.find(entry.first);
+			if (it == other.end() || !(it->second == entry.second))
+				return 0;
+		}
+		return 1;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	bool MonomialMap<K, V, hash_t, equal_t, alloc_t>::operator!=(const MonomialMap &other) const
+	{
+		return !(*this == other);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	alloc_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::get_allocator() const
+	{
+		return alloc_t(slot_alloc);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	uint32_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::fragment(size_t hash)
+	{
+		//Fibonacci hashing: the high bits of the product depend on all bits of the hash, even if the hash is weak in the low bits
+		return static_cast<uint32_t>((static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15) >> 32);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::home(uint32_t fragment) const
+	{
+		return fragment >> shift;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::probe(const K &key, uint32_t fragment) const
+	{
+		if (slots_count == 0)
+			return 0;
+		//an entry closer to its home than the probe means the key would have displaced it, so it's not there
+		for (size_t i = home(fragment), d = 1; metadata[i].distance >= d; i = (i + 1) & (slots_count - 1), d++)
+			if (metadata[i].distance == d && metadata[i].fragment == fragment && equal_t()(slots[i].first, key))
+				return i;
+		return slots_count;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::place(uint32_t fragment, size_t from, uint32_t distance)
+	{
+		//the entries from the slot up to the next empty one are richer than the new entry, so they all move one slot further
+		size_t empty = from;
+		while (metadata[empty].distance != 0)
+			empty = (empty + 1) & (slots_count - 1);
+		for (size_t i = empty; i != from;)
+		{
+			const size_t previous = (i - 1) & (slots_count - 1);
+			slot_traits::construct(slot_alloc, slots + i, std::move(slots[previous]));
+			slot_traits::destroy(slot_alloc, slots + previous);
+			metadata[i] = {metadata[previous].distance + 1, metadata[previous].fragment};
+			i = previous;
+		}
+		metadata[from] = {distance, fragment};
+		return from;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::place(uint32_t fragment)
+	{
+		size_t i = home(fragment);
+		uint32_t d = 1;
+		for (; metadata[i].distance >= d; i = (i + 1) & (slots_count - 1), d++)
+			;
+		return place(fragment, i, d);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::rehash(size_t count)
+	{
+		value_type *old_slots = slots;
+		Metadata *old_metadata = metadata;
+		const size_t old_count = slots_count;
+		allocate(count);
+		//the fragments give the new home slots, so no key is hashed again
+		for (size_t j = 0; j < old_count; j++)
+		{
+			if (old_metadata[j].distance == 0)
+				continue;
+			const size_t i = place(old_metadata[j].fragment);
+			slot_traits::construct(slot_alloc, slots + i, std::move(old_slots[j]));
+			slot_traits::destroy(slot_alloc, old_slots + j);
+		}
+		if (old_count != 0)
+		{
+			SYMMP_INSTRUMENT_COUNT(rehashes, 1);
+			slot_traits::deallocate(slot_alloc, old_slots, old_count);
+			metadata_traits::deallocate(metadata_alloc, old_metadata, old_count);
+		}
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::allocate(size_t count)
+	{
+		slots = slot_traits::allocate(slot_alloc, count);
+		metadata = metadata_traits::allocate(metadata_alloc, count);
+		for (size_t i = 0; i < count; i++)
+			metadata_traits::construct(metadata_alloc, metadata + i, Metadata{0, 0});
+		slots_count = count;
+		shift = 32;
+		while ((size_t(1) << (32 - shift)) < count)
+			shift--;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::deallocate()
+	{
+		if (slots_count != 0)
+		{
+			slot_traits::deallocate(slot_alloc, slots, slots_count);
+			metadata_traits::deallocate(metadata_alloc, metadata, slots_count);
+		}
+		slots = nullptr;
+		metadata = nullptr;
+		slots_count = 0;
+		shift = 32;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::destroy_entries()
+	{
+		for (size_t i = 0; i < slots_count && entries != 0; i++)
+			if (metadata[i].distance != 0)
+			{
+				slot_traits::destroy(slot_alloc, slots + i);
+				metadata[i].distance = 0;
+				entries--;
+			}
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::copy_entries(const MonomialMap &other)
+	{
+		//a table oversized by reserve is not copied as is: the copy is sized for the entries instead
+		const size_t count = other.entries == 0 ? 0 : slots_needed(other.entries);
+		if (slots_count != count)
+		{
+			deallocate();
+			if (count != 0)
+				allocate(count);
+		}
+		//entries counts the constructed copies and a slot is marked occupied only once its copy is, so a throwing copy leaves a destructible map
+		if (count == other.slots_count)
+		{ //same positions: the table is copied without probing
+			for (size_t i = 0; i < count; i++)
+				if (other.metadata[i].distance != 0)
+				{
+					slot_traits::construct(slot_alloc, slots + i, other.slots[i]);
+					metadata[i] = other.metadata[i];
+					entries++;
+				}
+		}
+		else
+		{ //the fragments give the new home slots, so no key is hashed again
+			for (size_t j = 0; j < other.slots_count; j++)
+				if (other.metadata[j].distance != 0)
+				{
+					const size_t i = place(other.metadata[j].fragment);
+					const Metadata placed = metadata[i];
+					metadata[i].distance = 0;
+					slot_traits::construct(slot_alloc, slots + i, other.slots[j]);
+					metadata[i] = placed;
+					entries++;
+				}
+		}
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	void MonomialMap<K, V, hash_t, equal_t, alloc_t>::steal(MonomialMap &other)
+	{
+		slots = std::exchange(other.slots, nullptr);
+		metadata = std::exchange(other.metadata, nullptr);
+		slots_count = std::exchange(other.slots_count, 0);
+		entries = std::exchange(other.entries, 0);
+		shift = std::exchange(other.shift, 32);
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	size_t MonomialMap<K, V, hash_t, equal_t, alloc_t>::slots_needed(size_t n)
+	{
+		size_t count = 8;
+		while (count * 4 < n * 5)
+			count *= 2;
+		return count;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::BasicIterator() : map(nullptr), slot(0) {}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::BasicIterator(map_t *map, size_t slot) : map(map), slot(slot) {}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	template <bool other_const, std::enable_if_t<is_const && !other_const, int>>
+	MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::BasicIterator(const BasicIterator<other_const> &other) : map(other.map), slot(other.slot) {}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::operator*() const -> reference
+	{
+		return map->slots[slot];
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::operator->() const -> pointer
+	{
+		return map->slots + slot;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::operator++() -> BasicIterator &
+	{
+		do
+			slot++;
+		while (slot < map->slots_count && map->metadata[slot].distance == 0);
+		return *this;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	auto MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::operator++(int) -> BasicIterator
+	{
+		auto previous = *this;
+		++*this;
+		return previous;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	bool MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::operator==(const BasicIterator &other) const
+	{
+		return slot == other.slot;
+	}
+
+	template <typename K, typename V, typename hash_t, typename equal_t, typename alloc_t>
+	template <bool is_const>
+	bool MonomialMap<K, V, hash_t, equal_t, alloc_t>::BasicIterator<is_const>::operator!=(const BasicIterator &other) const
+	{
+		return slot != other.slot;
+	}
+}
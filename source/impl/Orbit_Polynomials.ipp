@@ -0,0 +1,220 @@
+#pragma once
+#include "../Orbit_Polynomials.hpp"
+#include <numeric>
+
+///	@file
+///	@brief Implementation of Orbit_Polynomials.hpp
+
+namespace symmp
+{
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks>::OrbitPolynomial(const deg_t *dim_var, const std::string *name_var) : monomials(dim_var, name_var), dim_var(dim_var), name_var(name_var) {}
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks>::OrbitPolynomial(const poly_t &a, const deg_t *dim_var, const std::string *name_var) : OrbitPolynomial(dim_var, name_var)
+	{
+		for (auto it = a.begin(); it != a.end(); ++it)
+			if (canonical(it.exponent()) == it.exponent())
+				monomials.insert(it.exponent(), it.coeff());
+	}
+
+	template <typename poly_t, size_t blocks>
+	poly_t OrbitPolynomial<poly_t, blocks>::expand() const
+	{
+		poly_t a(dim_var, name_var);
+		for (auto it = monomials.begin(); it != monomials.end(); ++it)
+			for_each_permutation(it.exponent(), [&](const exp_t &exponent) { a.insert(exponent, it.coeff()); });
+		return a;
+	}
+
+	template <typename poly_t, size_t blocks>
+	const poly_t &OrbitPolynomial<poly_t, blocks>::representatives() const
+	{
+		return monomials;
+	}
+
+	template <typename poly_t, size_t blocks>
+	size_t OrbitPolynomial<poly_t, blocks>::number_of_monomials() const
+	{
+		return monomials.number_of_monomials();
+	}
+
+	template <typename poly_t, size_t blocks>
+	uint64_t OrbitPolynomial<poly_t, blocks>::number_of_expanded_monomials() const
+	{
+		uint64_t count = 0;
+		for (auto it = monomials.begin(); it != monomials.end(); ++it)
+			count += orbit_size(it.exponent());
+		return count;
+	}
+
+	template <typename poly_t, size_t blocks>
+	auto OrbitPolynomial<poly_t, blocks>::highest_term() const -> std::pair<exp_t, scl_t>
+	{
+		auto it = monomials.begin();
+		auto maxit = it;
+		for (++it; it != monomials.end(); ++it)
+			if (maxit.degree() < it.degree() || (maxit.degree() == it.degree() && maxit.exponent() < it.exponent()))
+				maxit = it;
+		return {maxit.exponent(), maxit.coeff()};
+	}
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks> &OrbitPolynomial<poly_t, blocks>::operator+=(const OrbitPolynomial &other)
+	{
+		monomials += other.monomials;
+		return *this;
+	}
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks> &OrbitPolynomial<poly_t, blocks>::operator-=(const OrbitPolynomial &other)
+	{
+		monomials -= other.monomials;
+		return *this;
+	}
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks> &OrbitPolynomial<poly_t, blocks>::operator*=(const OrbitPolynomial &other)
+	{
+		return *this = *this * other;
+	}
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks> &OrbitPolynomial<poly_t, blocks>::operator*=(scl_t scalar)
+	{
+		monomials *= scalar;
+		return *this;
+	}
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks> OrbitPolynomial<poly_t, blocks>::operator+(const OrbitPolynomial &other) const
+	{
+		OrbitPolynomial sum = *this;
+		return sum += other;
+	}
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks> OrbitPolynomial<poly_t, blocks>::operator-(const OrbitPolynomial &other) const
+	{
+		OrbitPolynomial difference = *this;
+		return difference -= other;
+	}
+
+	template <typename poly_t, size_t blocks>
+	OrbitPolynomial<poly_t, blocks> OrbitPolynomial<poly_t, blocks>::operator*(const OrbitPolynomial &other) const
+	{
+		std::map<exp_t, scl_t> sums;
+		std::map<exp_t, uint64_t> counts;
+		for (auto i = monomials.begin(); i != monomials.end(); ++i)
+			for (auto j = other.monomials.begin(); j != other.monomials.end(); ++j)
+			{
+				//keep the representative of the larger orbit and permute the other
+				exp_t fixed = i.exponent(), permuted = j.exponent();
+				uint64_t fixed_size = orbit_size(fixed);
+				if (orbit_size(permuted) > fixed_size)
+				{
+					std::swap(fixed, permuted);
+					fixed_size = orbit_size(fixed);
+				}
+				counts.clear();
+				for_each_permutation(permuted, [&](const exp_t &exponent) { counts[canonical(fixed + exponent)]++; });
+				const scl_t coeff = i.coeff() * j.coeff();
+				for (const auto &[exponent, count] : counts)
+				{
+					//count*fixed_size/size without overflowing: size/gcd divides fixed_size
+					const uint64_t size = orbit_size(exponent);
+					const uint64_t gcd = std::gcd(count, size);
+					const scl_t term = coeff * scl_t(count / gcd * (fixed_size / (size / gcd)));
+					auto [sum, inserted] = sums.try_emplace(exponent, term);
+					if (!inserted)
+						sum->second += term;
+				}
+			}
+		OrbitPolynomial product(dim_var, name_var);
+		for (const auto &[exponent, coeff] : sums)
+			if (coeff != 0)
+				product.monomials.insert(exponent, coeff);
+		return product;
+	}
+
+	template <typename poly_t, size_t blocks>
+	bool OrbitPolynomial<poly_t, blocks>::operator==(const OrbitPolynomial &other) const
+	{
+		return monomials == other.monomials;
+	}
+
+	template <typename poly_t, size_t blocks>
+	bool OrbitPolynomial<poly_t, blocks>::operator!=(const OrbitPolynomial &other) const
+	{
+		return !(*this == other);
+	}
+
+	template <typename poly_t, size_t blocks>
+	auto OrbitPolynomial<poly_t, blocks>::canonical(const exp_t &exponent) -> exp_t
+	{
+		auto sorted = columns(exponent);
+		std::sort(sorted.begin(), sorted.end(), std::greater<column_t>());
+		exp_t result = exponent;
+		set_columns(result, sorted);
+		return result;
+	}
+
+	template <typename poly_t, size_t blocks>
+	uint64_t OrbitPolynomial<poly_t, blocks>::orbit_size(const exp_t &exponent)
+	{
+		auto sorted = columns(exponent);
+		std::sort(sorted.begin(), sorted.end());
+		//the multinomial coefficient, as a product of binomial coefficients (each exact in 64 bits for n<=20)
+		uint64_t size = 1;
+		uint64_t remaining = sorted.size();
+		for (size_t first = 0; first < sorted.size();)
+		{
+			size_t last = first;
+			while (last < sorted.size() && sorted[last] == sorted[first])
+				last++;
+			const uint64_t run = last - first;
+			uint64_t binomial = 1;
+			for (uint64_t k = 1; k <= run; k++)
+				binomial = binomial * (remaining - run + k) / k;
+			size *= binomial;
+			remaining -= run;
+			first = last;
+		}
+		return size;
+	}
+
+	template <typename poly_t, size_t blocks>
+	auto OrbitPolynomial<poly_t, blocks>::columns(const exp_t &exponent) -> std::vector<column_t>
+	{
+		const size_t n = exponent.size() / blocks;
+		std::vector<column_t> result(n);
+		for (size_t i = 0; i < n; i++)
+			for (size_t b = 0; b < blocks; b++)
+				result[i][b] = exponent[i + b * n];
+		return result;
+	}
+
+	template <typename poly_t, size_t blocks>
+	void OrbitPolynomial<poly_t, blocks>::set_columns(exp_t &exponent, const std::vector<column_t> &columns)
+	{
+		const size_t n = columns.size();
+		for (size_t i = 0; i < n; i++)
+			for (size_t b = 0; b < blocks; b++)
+				exponent[i + b * n] = columns[i][b];
+	}
+
+	template <typename poly_t, size_t blocks>
+	template <class fun>
+	void OrbitPolynomial<poly_t, blocks>::for_each_permutation(const exp_t &exponent, const fun &receive)
+	{
+		auto permuted = columns(exponent);
+		std::sort(permuted.begin(), permuted.end());
+		exp_t result = exponent;
+		do
+		{
+			set_columns(result, permuted);
+			receive(static_cast<const exp_t &>(result));
+		} while (std::next_permutation(permuted.begin(), permuted.end()));
+	}
+}
@@ -0,0 +1,246 @@
+#pragma once
+#include "../Packed_Variables.hpp"
+
+///	@file
+///	@brief Implementation of Packed_Variables.hpp
+
+namespace symmp
+{
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	constexpr size_t PackedExponent<spec_t, T, N, _deg>::shift(size_t i)
+	{
+		return (lanes - 1 - i % lanes) * bits;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	constexpr auto PackedExponent<spec_t, T, N, _deg>::make_high_mask() -> std::array<uint64_t, words>
+	{
+		std::array<uint64_t, words> mask{};
+		for (size_t i = 0; i < words * lanes; i++)
+			mask[i / lanes] |= uint64_t(1) << (shift(i) + bits - 1);
+		return mask;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	constexpr auto PackedExponent<spec_t, T, N, _deg>::make_idempotent_mask() -> std::array<uint64_t, words>
+	{
+		std::array<uint64_t, words> mask{};
+		for (size_t i = spec_t::idempotent_start; i < N; i++)
+			mask[i / lanes] |= lane_mask << shift(i);
+		return mask;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	PackedExponent<spec_t, T, N, _deg>::PackedExponent() : data{}, deg(0) {}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	PackedExponent<spec_t, T, N, _deg>::PackedExponent(size_t) : PackedExponent() {}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	PackedExponent<spec_t, T, N, _deg>::PackedExponent(std::initializer_list<T> values) : PackedExponent()
+	{
+		size_t i = 0;
+		for (const auto v : values)
+			set(i++, v);
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	constexpr size_t PackedExponent<spec_t, T, N, _deg>::size()
+	{
+		return N;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	T PackedExponent<spec_t, T, N, _deg>::operator[](size_t i) const
+	{
+		return (data[i / lanes] >> shift(i)) & lane_mask;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	auto PackedExponent<spec_t, T, N, _deg>::operator[](size_t i) -> reference
+	{
+		return reference(*this, i);
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	void PackedExponent<spec_t, T, N, _deg>::set(size_t i, T value)
+	{
+		const auto w = spec_t::weight(i);
+		deg = deg - w * (*this)[i] + w * value;
+		auto &word = data[i / lanes];
+		word = (word & ~(lane_mask << shift(i))) | (uint64_t(value) << shift(i));
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	spec_t PackedExponent<spec_t, T, N, _deg>::operator+(const spec_t &other) const
+	{
+		spec_t v(static_cast<const spec_t &>(*this));
+		v += other;
+		return v;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	spec_t &PackedExponent<spec_t, T, N, _deg>::operator+=(const spec_t &other)
+	{
+		//lanewise addition without carries between lanes; idempotent lanes are 0 or 1 so their max is the bitwise or
+		for (size_t w = 0; w < words; w++)
+		{
+			const auto a = data[w], b = other.data[w], H = high_mask[w], Y = idempotent_mask[w];
+			const auto sum = ((a & ~H) + (b & ~H)) ^ ((a ^ b) & H);
+			data[w] = (sum & ~Y) | ((a | b) & Y);
+		}
+		deg += other.deg;
+		return static_cast<spec_t &>(*this);
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	spec_t PackedExponent<spec_t, T, N, _deg>::operator-(const spec_t &other) const
+	{
+		//lanewise subtraction without borrows between lanes; idempotent lanes are 0 or 1 so their distance is the bitwise xor
+		spec_t v;
+		for (size_t w = 0; w < words; w++)
+		{
+			const auto a = data[w], b = other.data[w], H = high_mask[w], Y = idempotent_mask[w];
+			const auto diff = ((a | H) - (b & ~H)) ^ ((a ^ ~b) & H);
+			v.data[w] = (diff & ~Y) | ((a ^ b) & Y);
+		}
+		v.deg = deg - other.deg;
+		return v;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	bool PackedExponent<spec_t, T, N, _deg>::divides(const spec_t &other) const
+	{
+		//a<=b on every lane iff no lane of b-a borrows
+		uint64_t borrows = 0;
+		for (size_t w = 0; w < words; w++)
+		{
+			const auto a = data[w], b = other.data[w], H = high_mask[w];
+			const auto diff = ((b | H) - (a & ~H)) ^ ((b ^ ~a) & H);
+			borrows |= ((~b & a) | (~(b ^ a) & diff)) & H;
+		}
+		return borrows == 0;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	bool PackedExponent<spec_t, T, N, _deg>::operator==(const PackedExponent &other) const
+	{
+		return data == other.data;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	bool PackedExponent<spec_t, T, N, _deg>::operator!=(const PackedExponent &other) const
+	{
+		return data != other.data;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	bool PackedExponent<spec_t, T, N, _deg>::operator<(const PackedExponent &other) const
+	{
+		return deg < other.deg || (deg == other.deg && data < other.data);
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	size_t PackedExponent<spec_t, T, N, _deg>::operator()() const
+	{
+		return hash<wy_hash>();
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	template <class hasher>
+	size_t PackedExponent<spec_t, T, N, _deg>::hash() const
+	{
+		return generic_hasher<std::array<uint64_t, words>, hasher>(data);
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	PackedExponent<spec_t, T, N, _deg>::reference::reference(PackedExponent &exponent, size_t i) : exponent(exponent), i(i) {}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	PackedExponent<spec_t, T, N, _deg>::reference::operator T() const
+	{
+		return static_cast<const PackedExponent &>(exponent)[i];
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	auto PackedExponent<spec_t, T, N, _deg>::reference::operator=(T value) -> reference &
+	{
+		exponent.set(i, value);
+		return *this;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	auto PackedExponent<spec_t, T, N, _deg>::reference::operator=(const reference &other) -> reference &
+	{
+		return *this = T(other);
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	auto PackedExponent<spec_t, T, N, _deg>::reference::operator+=(T value) -> reference &
+	{
+		return *this = T(T(*this) + value);
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	auto PackedExponent<spec_t, T, N, _deg>::reference::operator-=(T value) -> reference &
+	{
+		return *this = T(T(*this) - value);
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	auto PackedExponent<spec_t, T, N, _deg>::reference::operator++() -> reference &
+	{
+		return *this += 1;
+	}
+
+	template <typename spec_t, typename T, size_t N, typename _deg>
+	T PackedExponent<spec_t, T, N, _deg>::reference::operator++(int)
+	{
+		const T old = *this;
+		*this += 1;
+		return old;
+	}
+
+	template <typename T, size_t N, typename _deg>
+	constexpr _deg PackedStandardVariables<T, N, _deg>::weight(size_t)
+	{
+		return 1;
+	}
+
+	template <typename T, size_t N, typename _deg>
+	_deg PackedStandardVariables<T, N, _deg>::degree() const
+	{
+		return this->deg;
+	}
+
+	template <typename T, size_t N, typename _deg>
+	std::string PackedStandardVariables<T, N, _deg>::name(int i, int n)
+	{
+		return StandardVariables<>::name(i, n);
+	}
+
+	template <typename T, size_t N, typename _deg>
+	constexpr _deg PackedHalfIdempotentVariables<T, N, _deg>::weight(size_t i)
+	{
+		return i < N / 2;
+	}
+
+	template <typename T, size_t N, typename _deg>
+	_deg PackedHalfIdempotentVariables<T, N, _deg>::degree() const
+	{
+		return this->deg;
+	}
+
+	template <typename T, size_t N, typename _deg>
+	std::string PackedHalfIdempotentVariables<T, N, _deg>::name(int i, int num)
+	{
+		return HalfIdempotentVariables<>::name(i, num);
+	}
+
+	template <typename T, size_t N, typename _deg>
+	constexpr _deg PackedTwistedChernVariables<T, N, _deg>::weight(size_t)
+	{
+		return 0;
+	}
+}
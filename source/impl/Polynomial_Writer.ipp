@@ -0,0 +1,191 @@
+#pragma once
+#include "../Polynomial_Writer.hpp"
+
+///@file
+///@brief Implementation of Polynomial_Writer.hpp
+
+namespace symmp
+{
+
+	inline PolynomialWriter::PolynomialWriter(std::ostream &os, size_t chunk) : stream(&os), descriptor(-1), chunk(chunk), ok(1)
+	{
+		buffer.reserve(chunk);
+	}
+
+	inline PolynomialWriter::PolynomialWriter(const std::string &path, size_t chunk) : file(std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::trunc)), descriptor(-1), chunk(chunk)
+	{
+		stream = file.get();
+		ok = static_cast<bool>(*file);
+		buffer.reserve(chunk);
+	}
+
+#if defined(SYMMP_WRITE_DESCRIPTOR)
+	inline PolynomialWriter::PolynomialWriter(int descriptor, size_t chunk) : stream(nullptr), descriptor(descriptor), chunk(chunk), ok(1)
+	{
+		buffer.reserve(chunk);
+	}
+#endif
+
+	inline PolynomialWriter::~PolynomialWriter()
+	{
+		flush();
+	}
+
+	inline void PolynomialWriter::flush()
+	{
+		write_out();
+		if (stream)
+		{
+			stream->flush();
+			ok = ok && stream->good();
+		}
+	}
+
+	inline bool PolynomialWriter::good() const
+	{
+		return ok;
+	}
+
+	inline void PolynomialWriter::write_out()
+	{
+		if (buffer.empty())
+			return;
+		if (stream)
+		{
+			stream->write(buffer.data(), buffer.size());
+			ok = ok && stream->good();
+		}
+#if defined(SYMMP_WRITE_DESCRIPTOR)
+		else
+		{
+			const char *data = buffer.data();
+			size_t left = buffer.size();
+			while (left > 0 && ok)
+			{
+				const auto written = ::write(descriptor, data, left);
+				if (written < 0 && errno == EINTR)
+					continue;
+				ok = written > 0;
+				if (ok)
+				{
+					data += written;
+					left -= static_cast<size_t>(written);
+				}
+			}
+		}
+#endif
+		buffer.clear();
+	}
+
+	inline PolynomialWriter &PolynomialWriter::write(const char *data, size_t size)
+	{
+		buffer.append(data, size);
+		if (buffer.size() >= chunk)
+			write_out();
+		return *this;
+	}
+
+	inline PolynomialWriter &PolynomialWriter::operator<<(std::string_view text)
+	{
+		return write(text.data(), text.size());
+	}
+
+	inline PolynomialWriter &PolynomialWriter::operator<<(char c)
+	{
+		return write(&c, 1);
+	}
+
+	template <class T, std::enable_if_t<std::is_integral_v<T>, int>>
+	PolynomialWriter &PolynomialWriter::operator<<(T value)
+	{
+		char digits[std::numeric_limits<T>::digits10 + 3];
+		const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+		return write(digits, static_cast<size_t>(result.ptr - digits));
+	}
+
+	inline const std::vector<std::string> &PolynomialWriter::names(name_function_t function, int number_of_variables)
+	{
+		for (const auto &cached : cached_names)
+			if (cached.function == function && cached.number_of_variables == number_of_variables)
+				return cached.names;
+		Names built{function, number_of_variables, {}};
+		built.names.reserve(number_of_variables);
+		for (int i = 0; i < number_of_variables; i++)
+			built.names.push_back(function(i, number_of_variables));
+		cached_names.push_back(std::move(built));
+		return cached_names.back().names;
+	}
+
+	template <class scl_t>
+	void PolynomialWriter::write_scalar(const scl_t &coeff)
+	{
+		if constexpr (std::is_integral_v<scl_t>)
+			*this << coeff;
+		else
+		{
+			fallback.str(std::string());
+			fallback << coeff;
+			*this << fallback.str();
+		}
+	}
+
+	template <class scl_t, class exp_t, class fun>
+	void PolynomialWriter::write_monomial(const scl_t &coeff, const exp_t &exponent, const fun &variable_name)
+	{
+		//same format as Polynomial::print
+		bool havestar = 0;
+		if (coeff != 1)
+		{
+			write_scalar(coeff);
+			havestar = 1;
+		}
+		bool completelyzero = 1;
+		for (size_t i = 0; i < exponent.size(); i++)
+		{
+			if (exponent[i] != 0)
+			{
+				completelyzero = 0;
+				if (havestar)
+					*this << '*';
+				havestar = 1;
+				*this << variable_name(i);
+				if (exponent[i] > 1)
+					*this << '^' << static_cast<int>(exponent[i]);
+			}
+		}
+		if (completelyzero && coeff == 1)
+			*this << '1';
+	}
+
+	template <class container_t>
+	PolynomialWriter &PolynomialWriter::operator<<(const Polynomial<container_t> &a)
+	{
+		typedef typename Polynomial<container_t>::exp_t exp_t;
+		auto it = a.begin();
+		if (it == a.end())
+			return *this << '0';
+		const auto write_terms = [&](const auto &variable_name) {
+			write_monomial(it.coeff(), it.exponent(), variable_name);
+			for (++it; it != a.end(); ++it)
+			{
+				*this << " + ";
+				write_monomial(it.coeff(), it.exponent(), variable_name);
+			}
+		};
+		if constexpr (!implementation_details::has_name_function<exp_t>::value)
+		{
+			if (a.variable_names == nullptr)
+			{
+				std::cerr << "If exp_t does not implement a name(int,int) function then you must provide a valid pointer to the names of the variables in the constructor";
+				abort();
+			}
+			write_terms([&](size_t i) -> const std::string & { return a.variable_names[i]; });
+		}
+		else
+		{
+			const auto &variable_names = names(&exp_t::name, static_cast<int>(it.exponent().size()));
+			write_terms([&](size_t i) -> const std::string & { return variable_names[i]; });
+		}
+		return *this;
+	}
+}
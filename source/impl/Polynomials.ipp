@@ -44,13 +44,27 @@ namespace symmp
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
 	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::reserve(size_t n) {
-		if constexpr (_ord)
+		if constexpr (!_ord)
 			data_t::reserve(n);
 	}
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
 	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::insert(const exp_t& exponent, scl_t coeff) {
-		this->emplace(std::pair(this->compute_degree(exponent), exponent), coeff);
+		this->emplace(implementation_details::key_traits<_exp>::make(this->compute_degree(exponent), exponent), coeff);
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	template <class iter_t>
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::insert_sorted(iter_t first, iter_t last) {
+		if constexpr (!_ord)
+			data_t::reserve(data_t::size() + std::distance(first, last));
+		for (; first != last; ++first) {
+			auto key = implementation_details::key_traits<_exp>::make(this->compute_degree(first->first), first->first);
+			if constexpr (_ord)
+				this->emplace_hint(data_t::end(), std::move(key), first->second);
+			else
+				this->emplace(std::move(key), first->second);
+		}
 	}
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
@@ -60,11 +74,11 @@ namespace symmp
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
 	const _exp& DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::ConstIterator::exponent() const {
-		return (data_t::const_iterator::operator*().first).second;
+		return implementation_details::key_traits<_exp>::exponent(data_t::const_iterator::operator*().first);
 	}
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
 	auto DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::ConstIterator::degree() const ->  deg_t {
-		return (data_t::const_iterator::operator*().first).first;
+		return implementation_details::key_traits<_exp>::degree(data_t::const_iterator::operator*().first);
 	}
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
@@ -94,6 +108,36 @@ namespace symmp
 		}
 	}
 
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	MemoryUsage DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::memory_usage() const {
+		MemoryUsage usage;
+		usage.overhead = sizeof(*this);
+		if (data_t::empty())
+			return usage;
+		usage.monomials = data_t::size() * (sizeof(typename data_t::value_type) + implementation_details::exponent_heap_bytes<_exp>(data_t::begin()->first));
+		if constexpr (_ord)
+			usage.overhead += data_t::size() * implementation_details::tree_node_overhead;
+		else
+			usage.overhead += implementation_details::unordered_overhead(static_cast<const data_t&>(*this));
+		return usage;
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	size_t& DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::avoided_counter() {
+		thread_local size_t counter = 0;
+		return counter;
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	size_t DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::allocations_avoided() {
+		return avoided_counter();
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::reset_allocations_avoided() {
+		avoided_counter() = 0;
+	}
+
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
 	_scl& DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::Iterator::coeff() {
 		return data_t::iterator::operator*().second;
@@ -115,31 +159,798 @@ namespace symmp
 
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>	
-	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::add(const std::pair<const std::pair<deg_t, exp_t>, scl_t>& kvp) {
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::add(const typename data_t::value_type& kvp) {
 		add(kvp.first, kvp.second);
 	}
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
-	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::subtract(const std::pair<const std::pair<deg_t, exp_t>, scl_t>& kvp) {
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::subtract(const typename data_t::value_type& kvp) {
 		add(kvp.first, -kvp.second);
 	}
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
-	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::multiply_add(const std::pair<const std::pair<deg_t, exp_t>, scl_t >& kvp1, const std::pair<const std::pair <deg_t, exp_t>, scl_t >& kvp2) {
-		add(std::pair(kvp1.first.first + kvp2.first.first, kvp1.first.second + kvp2.first.second), kvp1.second * kvp2.second);
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::multiply_add(const typename data_t::value_type& kvp1, const typename data_t::value_type& kvp2) {
+		add(implementation_details::key_traits<_exp>::multiply(kvp1.first, kvp2.first), kvp1.second * kvp2.second);
 	}
 
 	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
-	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::add(const std::pair<deg_t, exp_t> key, scl_t value) {
-			auto pair = this->emplace(key, value);
-			if (!pair.second)
-			{ //already existing element
-				pair.first->second += value;
-				if (pair.first->second == 0)
-					this->erase(pair.first);
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::add(const key_t& key, scl_t value) {
+		//look up before inserting: emplace would allocate a node even if the monomial is already there
+		typename data_t::iterator it;
+		if constexpr (_ord)
+		{
+			it = this->lower_bound(key);
+			if (it == data_t::end() || this->key_comp()(key, it->first))
+			{
+				this->emplace_hint(it, key, value);
+				return;
+			}
+		}
+		else
+		{
+			//a single probe both looks the monomial up and inserts it if missing
+			bool inserted;
+			std::tie(it, inserted) = this->try_emplace(key, value);
+			if (inserted)
+				return;
+		}
+		//already existing element
+#if defined(SYMMP_INSTRUMENT)
+		avoided_counter()++;
+#endif
+		it->second += value;
+		if (it->second == 0)
+		{
+			SYMMP_INSTRUMENT_COUNT(cancelled_terms, 1);
+			this->erase(it);
+		}
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::add(const DefaultContainer& b) {
+		reserve(number_of_monomials() + b.number_of_monomials());
+		for (const auto& pair : static_cast<const data_t&>(b))
+			add(pair);
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::subtract(const DefaultContainer& b) {
+		reserve(number_of_monomials() + b.number_of_monomials());
+		for (const auto& pair : static_cast<const data_t&>(b))
+			subtract(pair);
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::multiply_add(const DefaultContainer& a, const DefaultContainer& b) {
+		reserve(number_of_monomials() + a.number_of_monomials() * b.number_of_monomials());
+		key_t scratch;
+		for (const auto& paira : static_cast<const data_t&>(a))
+			for (const auto& pairb : static_cast<const data_t&>(b))
+			{
+				implementation_details::key_traits<_exp>::multiply(scratch, paira.first, pairb.first);
+				add(scratch, paira.second * pairb.second);
+			}
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::multiply_add(const DefaultContainer& a, const DefaultContainer& b, deg_t max_degree) {
+		typedef implementation_details::key_traits<_exp> traits;
+		if (a.empty() || b.empty())
+			return;
+		const auto sorteda = implementation_details::sorted_by_degree<_exp>(static_cast<const data_t&>(a));
+		const auto sortedb = implementation_details::sorted_by_degree<_exp>(static_cast<const data_t&>(b));
+		const deg_t lowest = traits::degree(sortedb.front()->first);
+		key_t scratch;
+		for (const auto* paira : sorteda)
+		{
+			const deg_t degree = traits::degree(paira->first);
+			if (degree + lowest > max_degree)
+				break;
+			for (const auto* pairb : sortedb)
+			{
+				if (degree + traits::degree(pairb->first) > max_degree)
+					break;
+				traits::multiply(scratch, paira->first, pairb->first);
+				add(scratch, paira->second * pairb->second);
+			}
+		}
+	}
+
+	template <class _scl, class _exp, template<class...> class _cnt, bool _ord, class ... _arg>
+	void DefaultContainer<_scl, _exp, _cnt, _ord, _arg...>::multiply_monomial(const key_t& key) {
+		typedef implementation_details::key_traits<_exp> traits;
+		data_t result(data_t::get_allocator());
+		//distinct monomials can have the same product if the exponents have idempotent variables (eg y*y=y in HalfIdempotentVariables),
+		//so those are combined and dropped if they cancel
+		if constexpr (_ord)
+		{ //the order is usually preserved, so every node is hinted to go to the end
+			while (!data_t::empty())
+			{
+				auto node = data_t::extract(data_t::begin());
+				traits::multiply(node.key(), node.key(), key);
+				const auto it = result.insert(result.end(), std::move(node));
+				if (node && (it->second += node.mapped()) == 0) //the node is left unchanged if the key exists
+				{
+					SYMMP_INSTRUMENT_COUNT(cancelled_terms, 1);
+					result.erase(it);
+				}
 			}
-			//this is much faster than:	data[key] += value;	if (data[key] == 0)	data.erase(key);
 		}
+		else
+		{
+			result.reserve(number_of_monomials());
+			key_t scratch;
+			for (const auto& pair : static_cast<const data_t&>(*this))
+			{
+				traits::multiply(scratch, pair.first, key);
+				const auto [it, inserted] = result.try_emplace(scratch, pair.second);
+				if (!inserted && (it->second += pair.second) == 0)
+				{
+					SYMMP_INSTRUMENT_COUNT(cancelled_terms, 1);
+					result.erase(it);
+				}
+			}
+		}
+		static_cast<data_t&>(*this) = std::move(result);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	size_t FlatContainer<_scl, _exp, _arg...>::number_of_monomials() const {
+		return this->size();
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	bool FlatContainer<_scl, _exp, _arg...>::operator==(const FlatContainer& b) const {
+		return static_cast<const data_t&>(*this) == static_cast<const data_t&>(b);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	bool FlatContainer<_scl, _exp, _arg...>::operator!=(const FlatContainer& b) const {
+		return !(*this == b);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::reserve(size_t n) {
+		data_t::reserve(n);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::insert(const exp_t& exponent, scl_t coeff) {
+		key_t key(implementation_details::key_traits<_exp>::make(this->compute_degree(exponent), exponent));
+		if (this->empty() || data_t::back().first < key)
+			this->emplace_back(std::move(key), coeff);
+		else
+		{ //found before the key is moved into the pair, as the arguments of insert may be evaluated in any order
+			const auto position = std::lower_bound(data_t::begin(), data_t::end(), key, [](const auto& kvp, const auto& k) { return kvp.first < k; });
+			data_t::insert(position, std::pair(std::move(key), coeff));
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	template <class iter_t>
+	void FlatContainer<_scl, _exp, _arg...>::insert_sorted(iter_t first, iter_t last) {
+		const size_t existing = data_t::size();
+		data_t::reserve(existing + std::distance(first, last));
+		for (; first != last; ++first)
+			this->emplace_back(implementation_details::key_traits<_exp>::make(this->compute_degree(first->first), first->first), first->second);
+		const auto middle = data_t::begin() + existing;
+		if (existing != 0 && middle != data_t::end() && middle->first < (middle - 1)->first)
+			std::inplace_merge(data_t::begin(), middle, data_t::end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	_scl FlatContainer<_scl, _exp, _arg...>::ConstIterator::coeff() const {
+		return data_t::const_iterator::operator*().second;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	const _exp& FlatContainer<_scl, _exp, _arg...>::ConstIterator::exponent() const {
+		return implementation_details::key_traits<_exp>::exponent(data_t::const_iterator::operator*().first);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto FlatContainer<_scl, _exp, _arg...>::ConstIterator::degree() const -> deg_t {
+		return implementation_details::key_traits<_exp>::degree(data_t::const_iterator::operator*().first);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	FlatContainer<_scl, _exp, _arg...>::ConstIterator::ConstIterator(typename data_t::const_iterator it)
+		: data_t::const_iterator(it) {}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto FlatContainer<_scl, _exp, _arg...>::begin() const -> ConstIterator {
+		return ConstIterator(data_t::begin());
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto FlatContainer<_scl, _exp, _arg...>::end() const -> ConstIterator {
+		return ConstIterator(data_t::end());
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto FlatContainer<_scl, _exp, _arg...>::highest_term() const -> ConstIterator {
+		return ConstIterator(std::prev(data_t::end()));
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	MemoryUsage FlatContainer<_scl, _exp, _arg...>::memory_usage() const {
+		MemoryUsage usage;
+		usage.overhead = sizeof(*this) + (data_t::capacity() - data_t::size()) * sizeof(typename data_t::value_type);
+		if (!data_t::empty())
+			usage.monomials = data_t::size() * (sizeof(typename data_t::value_type) + implementation_details::exponent_heap_bytes<_exp>(data_t::front().first));
+		return usage;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	_scl& FlatContainer<_scl, _exp, _arg...>::Iterator::coeff() {
+		return data_t::iterator::operator*().second;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	FlatContainer<_scl, _exp, _arg...>::Iterator::Iterator(typename data_t::iterator it)
+		: data_t::iterator(it) {}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto FlatContainer<_scl, _exp, _arg...>::begin() -> Iterator {
+		return Iterator(data_t::begin());
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto FlatContainer<_scl, _exp, _arg...>::end() -> Iterator {
+		return Iterator(data_t::end());
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::add(const typename data_t::value_type& kvp) {
+		add(kvp.first, kvp.second);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::subtract(const typename data_t::value_type& kvp) {
+		add(kvp.first, -kvp.second);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::multiply_add(const typename data_t::value_type& kvp1, const typename data_t::value_type& kvp2) {
+		add(implementation_details::key_traits<_exp>::multiply(kvp1.first, kvp2.first), kvp1.second * kvp2.second);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::add(const key_t& key, scl_t value) {
+		auto it = std::lower_bound(data_t::begin(), data_t::end(), key, [](const auto& kvp, const auto& k) { return kvp.first < k; });
+		if (it == data_t::end() || key < it->first)
+			data_t::insert(it, std::pair(key, value));
+		else
+		{ //already existing element
+			it->second += value;
+			if (it->second == 0)
+			{
+				SYMMP_INSTRUMENT_COUNT(cancelled_terms, 1);
+				this->erase(it);
+			}
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::add(const FlatContainer& b) {
+		merge<0>(b);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::subtract(const FlatContainer& b) {
+		merge<1>(b);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::multiply_add(const FlatContainer& a, const FlatContainer& b) {
+		if (a.empty() || b.empty())
+			return;
+		//products are sorted and combined in chunks of rows of a so that the buffer stays bounded
+		constexpr size_t chunk_size = 1 << 16;
+		const size_t rows = std::max<size_t>(1, chunk_size / b.size());
+		data_t chunk(data_t::get_allocator());
+		chunk.reserve(std::min(a.size(), rows) * b.size());
+		for (size_t start = 0; start < a.size(); start += rows)
+		{
+			const size_t stop = std::min(a.size(), start + rows);
+			for (size_t i = start; i < stop; i++)
+				for (const auto& pairb : static_cast<const data_t&>(b))
+					chunk.emplace_back(implementation_details::key_traits<_exp>::multiply(a[i].first, pairb.first), a[i].second * pairb.second);
+			combine(chunk);
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::multiply_add(const FlatContainer& a, const FlatContainer& b, deg_t max_degree) {
+		typedef implementation_details::key_traits<_exp> traits;
+		if (a.empty() || b.empty())
+			return;
+		constexpr size_t chunk_size = 1 << 16;
+		const auto sorteda = implementation_details::sorted_by_degree<_exp>(static_cast<const data_t&>(a));
+		const auto sortedb = implementation_details::sorted_by_degree<_exp>(static_cast<const data_t&>(b));
+		const deg_t lowest = traits::degree(sortedb.front()->first);
+		data_t chunk(data_t::get_allocator());
+		for (const auto* paira : sorteda)
+		{
+			const deg_t degree = traits::degree(paira->first);
+			if (degree + lowest > max_degree)
+				break;
+			for (const auto* pairb : sortedb)
+			{
+				if (degree + traits::degree(pairb->first) > max_degree)
+					break;
+				chunk.emplace_back(traits::multiply(paira->first, pairb->first), paira->second * pairb->second);
+			}
+			if (chunk.size() >= chunk_size)
+				combine(chunk);
+		}
+		combine(chunk);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::multiply_monomial(const key_t& key) {
+		for (auto& pair : static_cast<data_t&>(*this))
+			implementation_details::key_traits<_exp>::multiply(pair.first, pair.first, key);
+		//the keys stay strictly increasing unless the exponents have idempotent variables (eg y*y=y in HalfIdempotentVariables),
+		//which can reorder them or make distinct monomials equal: then they are sorted and combined, which is only a linear check otherwise
+		if (std::adjacent_find(data_t::begin(), data_t::end(), [](const auto& x, const auto& y) { return !(x.first < y.first); }) != data_t::end())
+		{
+			data_t chunk(std::move(static_cast<data_t&>(*this)));
+			data_t::clear();
+			combine(chunk);
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void FlatContainer<_scl, _exp, _arg...>::combine(data_t& chunk) {
+		std::sort(chunk.begin(), chunk.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+		size_t last = 0; //combine equal keys in place, dropping those that cancel
+		for (size_t i = 0; i < chunk.size();)
+		{
+			size_t j = i + 1;
+			auto coeff = chunk[i].second;
+			for (; j < chunk.size() && !(chunk[i].first < chunk[j].first); j++)
+				coeff += chunk[j].second;
+			if (coeff != 0)
+			{
+				if (last != i)
+					chunk[last] = std::move(chunk[i]);
+				chunk[last++].second = coeff;
+			}
+			else
+				SYMMP_INSTRUMENT_COUNT(cancelled_terms, 1);
+			i = j;
+		}
+		chunk.resize(last);
+		if (this->empty())
+			data_t::swap(chunk);
+		else
+			merge<0>(chunk);
+		chunk.clear();
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	template <bool negate>
+	void FlatContainer<_scl, _exp, _arg...>::merge(const data_t& b) {
+		//merge backwards into the tail of *this so no allocation happens when the capacity suffices
+		data_t& a = *this;
+		const size_t m = a.size();
+		size_t i = m, j = b.size(), out = m + b.size();
+		a.resize(out);
+		while (j > 0)
+		{
+			if (i > 0 && b[j - 1].first < a[i - 1].first)
+				a[--out] = std::move(a[--i]);
+			else if (i > 0 && !(a[i - 1].first < b[j - 1].first))
+			{ //equal keys
+				--i;
+				--j;
+				auto coeff = negate ? a[i].second - b[j].second : a[i].second + b[j].second;
+				if (coeff != 0)
+				{
+					a[--out] = std::move(a[i]);
+					a[out].second = coeff;
+				}
+				else
+					SYMMP_INSTRUMENT_COUNT(cancelled_terms, 1);
+			}
+			else
+			{
+				--j;
+				a[--out] = typename data_t::value_type(b[j].first, negate ? -b[j].second : b[j].second);
+			}
+		}
+		if (out != i)
+			std::move(a.begin() + out, a.end(), a.begin() + i);
+		a.resize(i + (m + b.size() - out));
+	}
+
+
+	template <class _scl, class _exp, class ... _arg>
+	GradedContainer<_scl, _exp, _arg...>::GradedContainer(GradedContainer&& other) noexcept
+		: BaseContainer<_exp>(other), data_t(std::move(static_cast<data_t&>(other))), monomials(other.monomials) {
+		other.data_t::clear(); //a moved-from map is only guaranteed to be valid, not empty
+		other.monomials = 0;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::operator=(GradedContainer&& other) noexcept -> GradedContainer& {
+		if (this == &other)
+			return *this;
+		BaseContainer<_exp>::operator=(other);
+		data_t::operator=(std::move(static_cast<data_t&>(other)));
+		monomials = other.monomials;
+		other.data_t::clear();
+		other.monomials = 0;
+		return *this;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	size_t GradedContainer<_scl, _exp, _arg...>::number_of_monomials() const {
+		return monomials;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	bool GradedContainer<_scl, _exp, _arg...>::operator==(const GradedContainer& b) const {
+		return monomials == b.monomials && static_cast<const data_t&>(*this) == static_cast<const data_t&>(b);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	bool GradedContainer<_scl, _exp, _arg...>::operator!=(const GradedContainer& b) const {
+		return !(*this == b);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::reserve(size_t) {}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::insert(const exp_t& exponent, scl_t coeff) {
+		const auto degree = this->compute_degree(exponent);
+		auto& bucket = data_t::try_emplace(degree).first->second;
+		if (bucket.emplace(implementation_details::key_traits<_exp>::make(degree, exponent), coeff).second)
+			monomials++;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	template <class iter_t>
+	void GradedContainer<_scl, _exp, _arg...>::insert_sorted(iter_t first, iter_t last) {
+		std::vector<deg_t> degrees;
+		degrees.reserve(std::distance(first, last));
+		for (auto it = first; it != last; ++it)
+			degrees.push_back(this->compute_degree(it->first));
+		for (size_t i = 0; i < degrees.size();) {
+			size_t j = i;
+			while (j < degrees.size() && degrees[j] == degrees[i])
+				j++;
+			auto& bucket = data_t::try_emplace(degrees[i]).first->second;
+			bucket.reserve(bucket.size() + (j - i));
+			for (; i < j; i++, ++first)
+				if (bucket.emplace(implementation_details::key_traits<_exp>::make(degrees[i], first->first), first->second).second)
+					monomials++;
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	GradedContainer<_scl, _exp, _arg...>::ConstIterator::ConstIterator(typename data_t::const_iterator bucket, typename data_t::const_iterator last)
+		: bucket(bucket), last(last) {
+		if (bucket != last)
+			it = bucket->second.begin();
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	GradedContainer<_scl, _exp, _arg...>::ConstIterator::ConstIterator(typename data_t::const_iterator bucket, typename data_t::const_iterator last, typename bucket_t::const_iterator it)
+		: bucket(bucket), last(last), it(it) {}
+
+	template <class _scl, class _exp, class ... _arg>
+	_scl GradedContainer<_scl, _exp, _arg...>::ConstIterator::coeff() const {
+		return it->second;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	const _exp& GradedContainer<_scl, _exp, _arg...>::ConstIterator::exponent() const {
+		return implementation_details::key_traits<_exp>::exponent(it->first);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::ConstIterator::degree() const -> deg_t {
+		return bucket->first;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::ConstIterator::operator*() const -> const typename bucket_t::value_type& {
+		return *it;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::ConstIterator::operator->() const -> const typename bucket_t::value_type* {
+		return &*it;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::ConstIterator::operator++() -> ConstIterator& {
+		if (++it == bucket->second.end() && ++bucket != last)
+			it = bucket->second.begin();
+		return *this;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	bool GradedContainer<_scl, _exp, _arg...>::ConstIterator::operator==(const ConstIterator& other) const {
+		return bucket == other.bucket && (bucket == last || it == other.it);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	bool GradedContainer<_scl, _exp, _arg...>::ConstIterator::operator!=(const ConstIterator& other) const {
+		return !(*this == other);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::begin() const -> ConstIterator {
+		return ConstIterator(data_t::begin(), data_t::end());
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::end() const -> ConstIterator {
+		return ConstIterator(data_t::end(), data_t::end());
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::highest_term() const -> ConstIterator {
+		auto top = std::prev(data_t::end());
+		auto it = top->second.begin();
+		auto maxit = it;
+		for (++it; it != top->second.end(); ++it)
+			if (implementation_details::key_traits<_exp>::exponent(maxit->first) < implementation_details::key_traits<_exp>::exponent(it->first))
+				maxit = it;
+		return ConstIterator(top, data_t::end(), maxit);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	template <class fun>
+	void GradedContainer<_scl, _exp, _arg...>::extract_components(const fun& receive) {
+		for (auto& [degree, bucket] : static_cast<data_t&>(*this))
+		{
+			GradedContainer component(this->dimensions);
+			component.monomials = bucket.size();
+			component.data_t::emplace(degree, std::move(bucket));
+			receive(degree, std::move(component));
+		}
+		data_t::clear();
+		monomials = 0;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	MemoryUsage GradedContainer<_scl, _exp, _arg...>::memory_usage() const {
+		MemoryUsage usage;
+		usage.overhead = sizeof(*this);
+		if (monomials == 0)
+			return usage;
+		usage.monomials = monomials * (sizeof(typename bucket_t::value_type) + implementation_details::exponent_heap_bytes<_exp>(data_t::begin()->second.begin()->first));
+		for (const auto& [degree, bucket] : static_cast<const data_t&>(*this))
+			usage.overhead += sizeof(typename data_t::value_type) + implementation_details::tree_node_overhead + implementation_details::unordered_overhead(bucket);
+		return usage;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::extract_component(deg_t d) -> GradedContainer {
+		GradedContainer result(this->dimensions);
+		auto bucket = data_t::find(d);
+		if (bucket != data_t::end())
+		{
+			result.monomials = bucket->second.size();
+			result.data_t::emplace(d, std::move(bucket->second));
+			monomials -= result.monomials;
+			data_t::erase(bucket);
+		}
+		return result;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::component(deg_t d) const -> GradedContainer {
+		GradedContainer result(this->dimensions);
+		auto bucket = data_t::find(d);
+		if (bucket != data_t::end())
+		{
+			result.monomials = bucket->second.size();
+			result.data_t::emplace(d, bucket->second);
+		}
+		return result;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	GradedContainer<_scl, _exp, _arg...>::Iterator::Iterator(typename data_t::iterator bucket, typename data_t::iterator last)
+		: bucket(bucket), last(last) {
+		if (bucket != last)
+			it = bucket->second.begin();
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	_scl& GradedContainer<_scl, _exp, _arg...>::Iterator::coeff() {
+		return it->second;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::Iterator::operator++() -> Iterator& {
+		if (++it == bucket->second.end() && ++bucket != last)
+			it = bucket->second.begin();
+		return *this;
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	bool GradedContainer<_scl, _exp, _arg...>::Iterator::operator==(const Iterator& other) const {
+		return bucket == other.bucket && (bucket == last || it == other.it);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	bool GradedContainer<_scl, _exp, _arg...>::Iterator::operator!=(const Iterator& other) const {
+		return !(*this == other);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::begin() -> Iterator {
+		return Iterator(data_t::begin(), data_t::end());
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	auto GradedContainer<_scl, _exp, _arg...>::end() -> Iterator {
+		return Iterator(data_t::end(), data_t::end());
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::add(const typename bucket_t::value_type& kvp) {
+		auto bucket = data_t::try_emplace(implementation_details::key_traits<_exp>::degree(kvp.first)).first;
+		add(bucket->second, kvp.first, kvp.second);
+		prune(bucket);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::subtract(const typename bucket_t::value_type& kvp) {
+		auto bucket = data_t::try_emplace(implementation_details::key_traits<_exp>::degree(kvp.first)).first;
+		add(bucket->second, kvp.first, -kvp.second);
+		prune(bucket);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::multiply_add(const typename bucket_t::value_type& kvp1, const typename bucket_t::value_type& kvp2) {
+		add({implementation_details::key_traits<_exp>::multiply(kvp1.first, kvp2.first), kvp1.second * kvp2.second});
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::add(bucket_t& target, const key_t& key, scl_t value) {
+		auto it = target.find(key);
+		if (it == target.end())
+		{
+#if defined(SYMMP_INSTRUMENT)
+			const size_t buckets = target.bucket_count();
+			target.emplace(key, value);
+			if (target.size() > 1 && target.bucket_count() != buckets)
+				SYMMP_INSTRUMENT_COUNT(rehashes, 1);
+#else
+			target.emplace(key, value);
+#endif
+			monomials++;
+			return;
+		}
+		it->second += value;
+		if (it->second == 0)
+		{
+			SYMMP_INSTRUMENT_COUNT(cancelled_terms, 1);
+			target.erase(it);
+			monomials--;
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::reserve(bucket_t& bucket, size_t n) {
+#if defined(SYMMP_INSTRUMENT)
+		const size_t buckets = bucket.bucket_count();
+		bucket.reserve(n);
+		if (!bucket.empty() && bucket.bucket_count() != buckets)
+			SYMMP_INSTRUMENT_COUNT(rehashes, 1);
+#else
+		bucket.reserve(n);
+#endif
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::prune(typename data_t::iterator bucket) {
+		if (bucket->second.empty())
+			data_t::erase(bucket);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	template <bool negate>
+	void GradedContainer<_scl, _exp, _arg...>::add(const bucket_t& b, bucket_t& target) {
+		reserve(target, target.size() + b.size());
+		for (const auto& [key, value] : b)
+			add(target, key, negate ? -value : value);
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::add(const GradedContainer& b) {
+		for (const auto& [degree, bucket] : static_cast<const data_t&>(b))
+		{
+			auto target = data_t::try_emplace(degree).first;
+			add<0>(bucket, target->second);
+			prune(target);
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::subtract(const GradedContainer& b) {
+		for (const auto& [degree, bucket] : static_cast<const data_t&>(b))
+		{
+			auto target = data_t::try_emplace(degree).first;
+			add<1>(bucket, target->second);
+			prune(target);
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::multiply_add(const GradedContainer& a, const GradedContainer& b) {
+		key_t scratch;
+		for (const auto& [dega, bucketa] : static_cast<const data_t&>(a))
+			for (const auto& [degb, bucketb] : static_cast<const data_t&>(b))
+			{
+				auto target = data_t::try_emplace(dega + degb).first;
+				reserve(target->second, target->second.size() + bucketa.size() * bucketb.size());
+				for (const auto& paira : bucketa)
+					for (const auto& pairb : bucketb)
+					{
+						implementation_details::key_traits<_exp>::multiply(scratch, paira.first, pairb.first);
+						add(target->second, scratch, paira.second * pairb.second);
+					}
+				prune(target);
+			}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::multiply_add(const GradedContainer& a, const GradedContainer& b, deg_t max_degree) {
+		if (a.empty() || b.empty())
+			return;
+		key_t scratch;
+		const deg_t lowest = b.data_t::begin()->first;
+		for (const auto& [dega, bucketa] : static_cast<const data_t&>(a))
+		{
+			if (dega + lowest > max_degree)
+				break;
+			for (const auto& [degb, bucketb] : static_cast<const data_t&>(b))
+			{
+				if (dega + degb > max_degree)
+					break;
+				auto target = data_t::try_emplace(dega + degb).first;
+				reserve(target->second, target->second.size() + bucketa.size() * bucketb.size());
+				for (const auto& paira : bucketa)
+					for (const auto& pairb : bucketb)
+					{
+						implementation_details::key_traits<_exp>::multiply(scratch, paira.first, pairb.first);
+						add(target->second, scratch, paira.second * pairb.second);
+					}
+				prune(target);
+			}
+		}
+	}
+
+	template <class _scl, class _exp, class ... _arg>
+	void GradedContainer<_scl, _exp, _arg...>::multiply_monomial(const key_t& key) {
+		typedef implementation_details::key_traits<_exp> traits;
+		const deg_t shift = traits::degree(key);
+		data_t result;
+		key_t scratch;
+		monomials = 0; //recounted by add, which combines the monomials with the same product (eg y*y=y in HalfIdempotentVariables)
+		for (const auto& [degree, bucket] : static_cast<const data_t&>(*this))
+		{
+			bucket_t shifted(bucket.get_allocator());
+			shifted.reserve(bucket.size());
+			for (const auto& pair : bucket)
+			{
+				traits::multiply(scratch, pair.first, key);
+				add(shifted, scratch, pair.second);
+			}
+			if (!shifted.empty())
+				result.emplace_hint(result.end(), degree + shift, std::move(shifted));
+		}
+		static_cast<data_t&>(*this) = std::move(result);
+	}
 
 
 	template <class container_t>
@@ -157,6 +968,14 @@ namespace symmp
 	Polynomial<container_t>::Polynomial(int _number_of_variables, scl_t coeff, const deg_t* dimensions, const std::string* variable_names)
 		: Polynomial(exp_t(_number_of_variables), coeff, dimensions, variable_names) {}
 
+	template <class container_t>
+	template <class iter_t>
+	Polynomial<container_t>::Polynomial(sorted_range_t, iter_t first, iter_t last, const deg_t* dimensions, const std::string* variable_names)
+		: Polynomial(dimensions, variable_names)
+	{
+		this->insert_sorted(first, last);
+	}
+
 
 	template <class container_t>
 	size_t Polynomial<container_t>::number_of_variables() const
@@ -167,55 +986,176 @@ namespace symmp
 	template <class container_t>
 	auto Polynomial<container_t>::operator+=(const Polynomial& b) -> Polynomial&
 	{
-		this->reserve(this->number_of_monomials() + b.number_of_monomials());
-		for (const auto& pair : b)
-			this->add(pair);
+		this->add(b);
 		return *this;
 	}
 
 	template <class container_t>
 	auto Polynomial<container_t>::operator-=(const Polynomial& b) -> Polynomial&
 	{
-		this->reserve(this->number_of_monomials() + b.number_of_monomials());
-		for (const auto& pair : b)
-			this->subtract(pair);
+		this->subtract(b);
 		return *this;
 	}
 
 	template <class container_t>
-	auto Polynomial<container_t>::operator+(const Polynomial& b) const -> Polynomial
+	auto Polynomial<container_t>::operator+(const Polynomial& b) const & -> Polynomial
 	{
-		Polynomial sum;
-		sum.reserve(this->number_of_monomials() + b.number_of_monomials());
-		sum = *this;
+		Polynomial sum(*this);
 		sum += b;
 		return sum;
 	}
 
 	template <class container_t>
-	auto Polynomial<container_t>::operator-(const Polynomial& b) const -> Polynomial
+	auto Polynomial<container_t>::operator+(const Polynomial& b) && -> Polynomial
+	{
+		*this += b;
+		return std::move(*this);
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::operator+(Polynomial&& b) const & -> Polynomial
+	{
+		b += *this;
+		return std::move(b);
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::operator+(Polynomial&& b) && -> Polynomial
 	{
-		Polynomial diff;
-		diff.reserve(this->number_of_monomials() + b.number_of_monomials());
-		diff = *this;
+		*this += b;
+		return std::move(*this);
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::operator-(const Polynomial& b) const & -> Polynomial
+	{
+		Polynomial diff(*this);
 		diff -= b;
 		return diff;
 	}
 
+	template <class container_t>
+	auto Polynomial<container_t>::operator-(const Polynomial& b) && -> Polynomial
+	{
+		*this -= b;
+		return std::move(*this);
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::operator-(Polynomial&& b) const & -> Polynomial
+	{
+		b *= scl_t(-1);
+		b += *this;
+		return std::move(b);
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::operator-(Polynomial&& b) && -> Polynomial
+	{
+		*this -= b;
+		return std::move(*this);
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::multiply_monomial(const exp_t& exponent, scl_t coeff) -> Polynomial&
+	{
+		container_t::multiply_monomial(implementation_details::key_traits<exp_t>::make(this->compute_degree(exponent), exponent));
+		return *this *= coeff;
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::add_product(const Polynomial& b, const Polynomial& c, scl_t coeff) -> Polynomial&
+	{
+		if (this == &b || this == &c) //the monomials of *this would change while they are read
+			return *this += (b * c) *= coeff;
+		if (coeff == 0)
+			return *this;
+		if (coeff == 1)
+			this->multiply_add(b, c);
+		else if (b.number_of_monomials() <= c.number_of_monomials())
+			this->multiply_add(Polynomial(b) *= coeff, c);
+		else
+			this->multiply_add(b, Polynomial(c) *= coeff);
+		return *this;
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::subtract_product(const Polynomial& b, const Polynomial& c, scl_t coeff) -> Polynomial&
+	{
+		return add_product(b, c, -coeff);
+	}
+
 	template <class container_t>
 	auto Polynomial<container_t>::operator*(const Polynomial& b) const -> Polynomial
 	{
-		Polynomial product;
-		product.reserve(this->number_of_monomials() * b.number_of_monomials());
-		for (const auto& paira : *this)
-			for (const auto& pairb : b)
-				product.multiply_add(paira, pairb);
+		const auto& [min_products, threads] = parallel_settings();
+		if (min_products != 0 && this->number_of_monomials() * b.number_of_monomials() >= min_products)
+			return parallel_multiply(b, threads);
+		Polynomial product(this->dimensions, variable_names);
+		product.multiply_add(*this, b);
 		return product;
 	}
 
+	template <class container_t>
+	auto Polynomial<container_t>::parallel_multiply(const Polynomial& b, int threads) const -> Polynomial
+	{
+#ifdef SYMMP_OPEN_MP_ENABLED
+		if (threads == 0)
+			threads = omp_get_max_threads();
+		threads = std::min<size_t>(threads, this->number_of_monomials());
+		if (threads > 1 && !omp_in_parallel())
+		{
+			std::vector<typename container_t::ConstIterator> chunks; //the first monomial of each chunk
+			chunks.reserve(threads + 1);
+			size_t i = 0;
+			for (auto it = this->begin(); it != this->end(); ++it, i++)
+				if (i * threads % this->number_of_monomials() < static_cast<size_t>(threads))
+					chunks.push_back(it);
+			chunks.push_back(this->end());
+			//the partial products must not use the arena of the calling thread (which is also thread 0), as the result is one of them
+			std::vector<std::optional<Polynomial>> partial(threads);
+#pragma omp parallel for num_threads(threads) schedule(static, 1)
+			for (int t = 0; t < threads; t++)
+			{
+				ArenaScope heap(std::pmr::new_delete_resource());
+				Polynomial chunk(this->dimensions, variable_names);
+				for (auto it = chunks[t]; it != chunks[t + 1]; ++it)
+					chunk.add(*it);
+				partial[t].emplace(this->dimensions, variable_names);
+				partial[t]->multiply_add(chunk, b);
+			}
+			for (int step = 1; step < threads; step *= 2)
+#pragma omp parallel for num_threads(threads) schedule(static, 1)
+				for (int t = 0; t < threads - step; t += 2 * step)
+					*partial[t] += *partial[t + step];
+			return std::move(*partial[0]);
+		}
+#else
+		(void)threads;
+#endif
+		Polynomial product(this->dimensions, variable_names);
+		product.multiply_add(*this, b);
+		return product;
+	}
+
+	template <class container_t>
+	std::pair<size_t, int>& Polynomial<container_t>::parallel_settings()
+	{
+		static std::pair<size_t, int> settings(0, 0);
+		return settings;
+	}
+
+	template <class container_t>
+	void Polynomial<container_t>::set_parallel_multiplication(size_t min_products, int threads)
+	{
+		parallel_settings() = {min_products, threads};
+	}
+
 	template <class container_t>
 	auto Polynomial<container_t>::operator*=(const Polynomial& b) -> Polynomial&
 	{
+		if (b.number_of_monomials() == 1 && this != &b)
+			return multiply_monomial(b.begin().exponent(), b.begin().coeff());
 		*this = operator*(b);
 		return *this;
 	}
@@ -240,16 +1180,242 @@ namespace symmp
 		static_assert(std::is_integral_v<T>, "A polynomial may only be raised to a (nonnegative) integer power");
 		if (p == 0)
 			return Polynomial(number_of_variables(), 1, this->dimensions, variable_names);
-		if (p == 1)
+		if (p == 1 || this->number_of_monomials() == 0)
 			return *this;
-		Polynomial prod;
-		// prod.reserve(power(number_of_variables(),p)); //actually slower due to how relations work
-		prod = *this;
+		const size_t m = this->number_of_monomials();
+		size_t compositions = 1; //the number of terms p!/(p_1!...p_m!) of the multinomial expansion, capped at the cost of multiplying p times
+		const size_t cost = (p - 1) * m * m;
+		for (size_t i = 1; i <= static_cast<size_t>(p) && compositions <= cost; i++)
+			compositions = compositions * (m - 1 + i) / i;
+		if (compositions <= cost && is_squarefree())
+			return multinomial_power(p);
+		if (number_of_used_variables() <= 1)
+			return square_and_multiply(p);
+		Polynomial prod(*this);
 		for (T k = 1; k < p; k++)
 			prod *= *this;
 		return prod;
 	}
 
+	template <class container_t>
+	bool Polynomial<container_t>::is_squarefree() const
+	{
+		for (const auto& [key, coeff] : *this)
+		{
+			const auto& exponent = implementation_details::key_traits<exp_t>::exponent(key);
+			for (size_t i = 0; i < exponent.size(); i++)
+				if (exponent[i] > 1)
+					return 0;
+		}
+		return 1;
+	}
+
+	template <class container_t>
+	size_t Polynomial<container_t>::number_of_used_variables() const
+	{
+		std::vector<bool> used(number_of_variables(), 0);
+		for (const auto& [key, coeff] : *this)
+		{
+			const auto& exponent = implementation_details::key_traits<exp_t>::exponent(key);
+			for (size_t i = 0; i < exponent.size(); i++)
+				used[i] = used[i] || (exponent[i] != 0);
+		}
+		return std::count(used.begin(), used.end(), 1);
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::multinomial_power(size_t p) const -> Polynomial
+	{
+		typedef implementation_details::key_traits<exp_t> traits;
+		typedef implementation_details::pair_t<exp_t> key_t;
+		//(c_1m_1+...+c_km_k)^p is the sum of p!/(p_1!...p_k!) (c_1m_1)^{p_1}...(c_km_k)^{p_k} over all p_1+...+p_k=p
+		std::vector<std::vector<scl_t>> binomial(p + 1); //binomial[n][j]=n choose j
+		for (size_t n = 0; n <= p; n++)
+		{
+			binomial[n].assign(n + 1, 1);
+			for (size_t j = 1; j < n; j++)
+				binomial[n][j] = binomial[n - 1][j - 1] + binomial[n - 1][j];
+		}
+		std::vector<std::vector<std::pair<key_t, scl_t>>> powers; //powers[i][j-1]=(c_im_i)^j
+		for (const auto& [key, coeff] : *this)
+		{
+			powers.emplace_back();
+			powers.back().reserve(p);
+			powers.back().emplace_back(key, coeff);
+			for (size_t j = 1; j < p; j++)
+				powers.back().emplace_back(traits::multiply(powers.back().back().first, key), powers.back().back().second * coeff);
+		}
+		Polynomial result(this->dimensions, variable_names);
+		std::vector<key_t> partial(powers.size()); //partial[i]=product of the chosen powers of m_1,...,m_{i+1}
+		//chooses the power of m_{i+1} with the given power left over for m_{i+1},...,m_k; prev is the product so far (nullptr if it's 1)
+		auto expand = [&](const auto& self, size_t i, size_t left, const key_t* prev, const scl_t& coeff) -> void {
+			const size_t first = (i + 1 == powers.size()) ? left : 0; //the last monomial takes what's left
+			for (size_t j = first; j <= left; j++)
+			{
+				const key_t* current = prev;
+				scl_t c = coeff * binomial[left][j];
+				if (j > 0)
+				{
+					c *= powers[i][j - 1].second;
+					if (prev)
+						traits::multiply(partial[i], *prev, powers[i][j - 1].first);
+					else
+						partial[i] = powers[i][j - 1].first;
+					current = &partial[i];
+				}
+				if (c == 0)
+					continue;
+				if (j == left)
+					result.add({*current, c});
+				else
+					self(self, i + 1, left - j, current, c);
+			}
+		};
+		expand(expand, 0, p, nullptr, scl_t(1));
+		return result;
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::square_and_multiply(size_t p) const -> Polynomial
+	{
+		Polynomial base(*this), result;
+		bool first = 1; //result is still 1
+		while (1)
+		{
+			if (p & 1)
+			{
+				if (first)
+					result = base;
+				else
+					result *= base;
+				first = 0;
+			}
+			p >>= 1;
+			if (p == 0)
+				return result;
+			base *= base;
+		}
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::truncated_multiply(const Polynomial& b, deg_t max_degree) const -> Polynomial
+	{
+		Polynomial product(this->dimensions, variable_names);
+		product.multiply_add(*this, b, max_degree);
+		return product;
+	}
+
+	template <class container_t>
+	template <typename T>
+	auto Polynomial<container_t>::truncated_power(T p, deg_t max_degree) const -> Polynomial
+	{
+		static_assert(std::is_integral_v<T>, "A polynomial may only be raised to a (nonnegative) integer power");
+		Polynomial result(number_of_variables(), 1, this->dimensions, variable_names);
+		if (p == 0)
+			return result.truncated(max_degree);
+		Polynomial base = truncated(max_degree);
+		bool first = 1; //result is still 1
+		while (1)
+		{
+			if (p & 1)
+			{
+				result = first ? base : result.truncated_multiply(base, max_degree);
+				first = 0;
+			}
+			p >>= 1;
+			if (p == 0 || result.number_of_monomials() == 0)
+				return result;
+			base = base.truncated_multiply(base, max_degree);
+			if (base.number_of_monomials() == 0)
+				return Polynomial(this->dimensions, variable_names);
+		}
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::truncated(deg_t max_degree) const -> Polynomial
+	{
+		Polynomial result(this->dimensions, variable_names);
+		for (auto it = this->begin(); it != this->end(); ++it)
+			if (!(max_degree < it.degree()))
+				result.insert(it.exponent(), it.coeff());
+		return result;
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::homogeneous_component(deg_t d) const -> Polynomial
+	{
+		Polynomial component(this->dimensions, variable_names);
+		if constexpr (implementation_details::is_graded_container<container_t>::value)
+			static_cast<container_t&>(component) = this->component(d);
+		else
+			for (auto it = this->begin(); it != this->end(); ++it)
+				if (it.degree() == d)
+					component.insert(it.exponent(), it.coeff());
+		return component;
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::extract_homogeneous_component(deg_t d) -> Polynomial
+	{
+		if constexpr (implementation_details::is_graded_container<container_t>::value)
+		{
+			Polynomial component(this->dimensions, variable_names);
+			static_cast<container_t&>(component) = this->extract_component(d);
+			return component;
+		}
+		else
+		{
+			Polynomial component = homogeneous_component(d);
+			*this -= component;
+			return component;
+		}
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::homogeneous_components() && -> std::map<deg_t, Polynomial>
+	{
+		if constexpr (implementation_details::is_graded_container<container_t>::value)
+		{
+			std::map<deg_t, Polynomial> components;
+			this->extract_components([&](deg_t degree, container_t&& component) {
+				auto it = components.try_emplace(components.end(), degree, this->dimensions, variable_names);
+				static_cast<container_t&>(it->second) = std::move(component);
+			});
+			return components;
+		}
+		else
+			return homogeneous_components();
+	}
+
+	template <class container_t>
+	auto Polynomial<container_t>::homogeneous_components() const & -> std::map<deg_t, Polynomial>
+	{
+		std::map<deg_t, Polynomial> components;
+		for (auto it = this->begin(); it != this->end(); ++it)
+		{
+			auto component = components.try_emplace(it.degree(), this->dimensions, variable_names).first;
+			component->second.insert(it.exponent(), it.coeff());
+		}
+		return components;
+	}
+
+	template <class container_t>
+	bool Polynomial<container_t>::is_homogeneous(deg_t d) const
+	{
+		for (auto it = this->begin(); it != this->end(); ++it)
+			if (it.degree() != d)
+				return 0;
+		return 1;
+	}
+
+	template <class container_t>
+	MemoryUsage Polynomial<container_t>::memory_usage() const
+	{
+		MemoryUsage usage = container_t::memory_usage();
+		usage.overhead += sizeof(Polynomial) - sizeof(container_t);
+		return usage;
+	}
+
 	template <class container_t>
 	template <typename fun>
 	void Polynomial<container_t>::print(scl_t coeff, const exp_t& exponent, std::ostream& os, const fun& variable_names) const
@@ -284,6 +1450,11 @@ namespace symmp
 	void Polynomial<container_t>::print(std::ostream& os, const fun& variable_name_fun) const
 	{
 		auto it = this->begin();
+		if (it == this->end())
+		{ //like PolynomialWriter
+			os << '0';
+			return;
+		}
 		print(it.coeff(), it.exponent(), os, variable_name_fun);
 		for (++it; it != this->end(); ++it)
 		{
@@ -0,0 +1,94 @@
+#pragma once
+#include "../Product_Cache.hpp"
+
+///	@file
+///	@brief Implementation of Product_Cache.hpp
+
+namespace symmp
+{
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	ProductCache<key_t, poly_t, hash_t>::ProductCache(size_t capacity, bool thread_safe) : capacity(capacity), thread_safe(thread_safe) {}
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	ProductCache<key_t, poly_t, hash_t>::ProductCache(const ProductCache &other) : ProductCache(other.capacity, other.thread_safe) {}
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	std::unique_lock<std::mutex> ProductCache<key_t, poly_t, hash_t>::lock() const
+	{
+		return thread_safe ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+	}
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	std::shared_ptr<const poly_t> ProductCache<key_t, poly_t, hash_t>::find(const key_t &key, bool count) const
+	{
+		if (capacity == 0)
+			return nullptr;
+		auto guard = lock();
+		auto it = entries.find(key);
+		std::shared_ptr<const poly_t> found = (it == entries.end()) ? nullptr : it->second;
+		if (count)
+			(found ? stats.hits : stats.misses)++;
+		return found;
+	}
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	void ProductCache<key_t, poly_t, hash_t>::insert(const key_t &key, const poly_t &poly)
+	{
+		if (poly.number_of_monomials() > capacity)
+			return;
+		std::shared_ptr<const poly_t> copy;
+		{ //copy outside of the lock and of the arena of the caller
+			ArenaScope heap(std::pmr::new_delete_resource());
+			copy = std::make_shared<const poly_t>(poly);
+		}
+		auto guard = lock();
+		if (!entries.emplace(key, copy).second)
+			return;
+		order.push_back(key);
+		stats.entries++;
+		stats.monomials += poly.number_of_monomials();
+		while (stats.monomials > capacity)
+		{
+			auto it = entries.find(order.front());
+			stats.monomials -= it->second->number_of_monomials();
+			stats.entries--;
+			stats.evictions++;
+			entries.erase(it);
+			order.pop_front();
+		}
+	}
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	void ProductCache<key_t, poly_t, hash_t>::count(bool hit) const
+	{
+		auto guard = lock();
+		(hit ? stats.hits : stats.misses)++;
+	}
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	void ProductCache<key_t, poly_t, hash_t>::configure(size_t new_capacity, bool new_thread_safe)
+	{
+		clear();
+		auto guard = lock();
+		capacity = new_capacity;
+		thread_safe = new_thread_safe;
+	}
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	void ProductCache<key_t, poly_t, hash_t>::clear()
+	{
+		auto guard = lock();
+		entries.clear();
+		order.clear();
+		stats.entries = 0;
+		stats.monomials = 0;
+	}
+
+	template <typename key_t, typename poly_t, typename hash_t>
+	CacheStatistics ProductCache<key_t, poly_t, hash_t>::statistics() const
+	{
+		auto guard = lock();
+		return stats;
+	}
+}
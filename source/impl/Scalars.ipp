@@ -0,0 +1,437 @@
+#pragma once
+#include "../Scalars.hpp"
+
+///@file
+///@brief Implementation of Scalars.hpp
+
+namespace symmp
+{
+
+	template <uint64_t p>
+	ModularInteger<p>::ModularInteger() : value(0) {}
+
+	template <uint64_t p>
+	template <class T, std::enable_if_t<std::is_integral_v<T>, int>>
+	ModularInteger<p>::ModularInteger(T integer)
+	{
+		uint64_t r;
+		if constexpr (std::is_signed_v<T>)
+		{ //-(integer+1) doesn't overflow
+			r = integer < 0 ? p - 1 - static_cast<uint64_t>(-(integer + 1)) % p : static_cast<uint64_t>(integer) % p;
+		}
+		else
+			r = static_cast<uint64_t>(integer) % p;
+		constexpr uint64_t square = montgomery_square();
+		value = multiply(r, square);
+	}
+
+	template <uint64_t p>
+	uint64_t ModularInteger<p>::residue() const
+	{
+		return reduce(0, value);
+	}
+
+	template <uint64_t p>
+	int64_t ModularInteger<p>::balanced() const
+	{
+		const uint64_t r = residue();
+		return r > p / 2 ? -static_cast<int64_t>(p - r) : static_cast<int64_t>(r);
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::inverse() const -> ModularInteger
+	{
+		if (value == 0)
+		{
+			std::cerr << "Division by zero modulo " << p << "\n";
+			abort();
+		}
+		//Fermat's little theorem: a^(p-2) is the inverse of a
+		ModularInteger result = 1, power = *this;
+		for (uint64_t e = p - 2; e != 0; e >>= 1)
+		{
+			if (e & 1)
+				result *= power;
+			power *= power;
+		}
+		return result;
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator+=(const ModularInteger &other) -> ModularInteger &
+	{
+		value += other.value; //both are less than p<2^63 so this doesn't overflow
+		if (value >= p)
+			value -= p;
+		return *this;
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator-=(const ModularInteger &other) -> ModularInteger &
+	{
+		value = value >= other.value ? value - other.value : value + (p - other.value);
+		return *this;
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator*=(const ModularInteger &other) -> ModularInteger &
+	{
+		value = multiply(value, other.value);
+		return *this;
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator/=(const ModularInteger &other) -> ModularInteger &
+	{
+		return *this *= other.inverse();
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator+(const ModularInteger &other) const -> ModularInteger
+	{
+		auto sum = *this;
+		return sum += other;
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator-(const ModularInteger &other) const -> ModularInteger
+	{
+		auto difference = *this;
+		return difference -= other;
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator*(const ModularInteger &other) const -> ModularInteger
+	{
+		return from_montgomery(multiply(value, other.value));
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator/(const ModularInteger &other) const -> ModularInteger
+	{
+		return *this * other.inverse();
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::operator-() const -> ModularInteger
+	{
+		return from_montgomery(value == 0 ? 0 : p - value);
+	}
+
+	template <uint64_t p>
+	bool ModularInteger<p>::operator==(const ModularInteger &other) const
+	{
+		return value == other.value;
+	}
+
+	template <uint64_t p>
+	bool ModularInteger<p>::operator!=(const ModularInteger &other) const
+	{
+		return value != other.value;
+	}
+
+	template <uint64_t p>
+	auto ModularInteger<p>::from_montgomery(uint64_t value) -> ModularInteger
+	{
+		ModularInteger a;
+		a.value = value;
+		return a;
+	}
+
+	template <uint64_t p>
+	uint64_t ModularInteger<p>::reduce(uint64_t high, uint64_t low)
+	{
+		//adding m*p makes the low half vanish, and the sum is less than 2p*2^64
+		constexpr uint64_t inverse = negative_inverse();
+		const uint64_t m = low * inverse;
+		uint64_t mp_high;
+		implementation_details::multiply_wide(m, p, mp_high);
+		const uint64_t result = high + mp_high + (low != 0); //the low halves sum to 0 or 2^64
+		return result >= p ? result - p : result;
+	}
+
+	template <uint64_t p>
+	uint64_t ModularInteger<p>::multiply(uint64_t a, uint64_t b)
+	{
+		uint64_t high;
+		const uint64_t low = implementation_details::multiply_wide(a, b, high);
+		return reduce(high, low);
+	}
+
+	template <uint64_t p>
+	constexpr uint64_t ModularInteger<p>::negative_inverse()
+	{
+		//Newton's iteration doubles the number of correct low bits: p*p==1 modulo 8, and 3*2^5>64
+		uint64_t inverse = p;
+		for (int i = 0; i < 5; i++)
+			inverse *= 2 - p * inverse;
+		return 0 - inverse;
+	}
+
+	template <uint64_t p>
+	constexpr uint64_t ModularInteger<p>::montgomery_square()
+	{
+		uint64_t r = (0 - p) % p; //2^64 modulo p
+		for (int i = 0; i < 64; i++)
+			r = r >= p - r ? r - (p - r) : r + r;
+		return r;
+	}
+
+	template <uint64_t p>
+	std::ostream &operator<<(std::ostream &os, const ModularInteger<p> &a)
+	{
+		return os << a.balanced();
+	}
+
+	template <class T>
+	CheckedInteger<T>::CheckedInteger() : value(0) {}
+
+	template <class T>
+	CheckedInteger<T>::CheckedInteger(T value) : value(value) {}
+
+	template <class T>
+	template <class S, std::enable_if_t<std::is_integral_v<S> && !std::is_same_v<S, T>, int>>
+	CheckedInteger<T>::CheckedInteger(S integer) : value(static_cast<T>(integer))
+	{
+		bool sign_changed = value < 0;
+		if constexpr (std::is_signed_v<S>)
+			sign_changed = sign_changed != (integer < 0);
+		if (static_cast<S>(value) != integer || sign_changed)
+			fail("overflow in conversion");
+	}
+
+	template <class T>
+	T CheckedInteger<T>::get() const
+	{
+		return value;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator+=(const CheckedInteger &other) -> CheckedInteger &
+	{
+#if defined(__GNUC__)
+		if (__builtin_add_overflow(value, other.value, &value))
+			fail("overflow in addition");
+#else
+		if ((other.value > 0 && value > std::numeric_limits<T>::max() - other.value) || (other.value < 0 && value < std::numeric_limits<T>::min() - other.value))
+			fail("overflow in addition");
+		value += other.value;
+#endif
+		return *this;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator-=(const CheckedInteger &other) -> CheckedInteger &
+	{
+#if defined(__GNUC__)
+		if (__builtin_sub_overflow(value, other.value, &value))
+			fail("overflow in subtraction");
+#else
+		if ((other.value < 0 && value > std::numeric_limits<T>::max() + other.value) || (other.value > 0 && value < std::numeric_limits<T>::min() + other.value))
+			fail("overflow in subtraction");
+		value -= other.value;
+#endif
+		return *this;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator*=(const CheckedInteger &other) -> CheckedInteger &
+	{
+#if defined(__GNUC__)
+		if (__builtin_mul_overflow(value, other.value, &value))
+			fail("overflow in multiplication");
+#else
+		if (value != 0 && other.value != 0)
+		{
+			const T product = static_cast<T>(static_cast<std::make_unsigned_t<T>>(value) * static_cast<std::make_unsigned_t<T>>(other.value));
+			if ((value == -1 && other.value == std::numeric_limits<T>::min()) || (other.value == -1 && value == std::numeric_limits<T>::min()) || product / other.value != value)
+				fail("overflow in multiplication");
+			value = product;
+		}
+		else
+			value = 0;
+#endif
+		return *this;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator/=(const CheckedInteger &other) -> CheckedInteger &
+	{
+		if (other.value == 0)
+			fail("division by zero");
+		if (other.value == -1)
+			return *this = -*this; //the quotient of the minimum by -1 overflows
+		if (value % other.value != 0)
+			fail("inexact division");
+		value /= other.value;
+		return *this;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator+(const CheckedInteger &other) const -> CheckedInteger
+	{
+		auto sum = *this;
+		return sum += other;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator-(const CheckedInteger &other) const -> CheckedInteger
+	{
+		auto difference = *this;
+		return difference -= other;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator*(const CheckedInteger &other) const -> CheckedInteger
+	{
+		auto product = *this;
+		return product *= other;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator/(const CheckedInteger &other) const -> CheckedInteger
+	{
+		auto quotient = *this;
+		return quotient /= other;
+	}
+
+	template <class T>
+	auto CheckedInteger<T>::operator-() const -> CheckedInteger
+	{
+		return CheckedInteger(0) - *this;
+	}
+
+	template <class T>
+	bool CheckedInteger<T>::operator==(const CheckedInteger &other) const
+	{
+		return value == other.value;
+	}
+
+	template <class T>
+	bool CheckedInteger<T>::operator!=(const CheckedInteger &other) const
+	{
+		return value != other.value;
+	}
+
+	template <class T>
+	bool CheckedInteger<T>::operator<(const CheckedInteger &other) const
+	{
+		return value < other.value;
+	}
+
+	template <class T>
+	bool CheckedInteger<T>::operator>(const CheckedInteger &other) const
+	{
+		return value > other.value;
+	}
+
+	template <class T>
+	bool CheckedInteger<T>::operator<=(const CheckedInteger &other) const
+	{
+		return value <= other.value;
+	}
+
+	template <class T>
+	bool CheckedInteger<T>::operator>=(const CheckedInteger &other) const
+	{
+		return value >= other.value;
+	}
+
+	template <class T>
+	void CheckedInteger<T>::fail(const char *error)
+	{
+		std::cerr << "CheckedInteger: " << error << "\n";
+		abort();
+	}
+
+	template <class T>
+	std::ostream &operator<<(std::ostream &os, const CheckedInteger<T> &a)
+	{
+		if constexpr (sizeof(T) <= sizeof(int64_t))
+			return os << a.get();
+		else
+		{ //the remainders of a negative number are nonpositive, so the minimum needs no special case
+			std::string digits;
+			T value = a.get();
+			do
+			{
+				const T digit = value % 10;
+				digits.push_back(static_cast<char>('0' + (digit < 0 ? -digit : digit)));
+				value /= 10;
+			} while (value != 0);
+			if (a.get() < 0)
+				digits.push_back('-');
+			return os << std::string(digits.rbegin(), digits.rend());
+		}
+	}
+
+	template <class int_t, uint64_t... p>
+	int_t crt_reconstruct(const ModularInteger<p> &...residues)
+	{
+		constexpr size_t count = sizeof...(p);
+		const std::array<uint64_t, count> moduli{p...};
+		std::array<int64_t, count> digits{}; //x=digits[0]+digits[1]*p_0+digits[2]*p_0*p_1+...
+		size_t i = 0;
+		//the next digit is found modulo the next prime, from the digits so far
+		const auto next_digit = [&](const auto &residue) {
+			typedef std::decay_t<decltype(residue)> mod_t;
+			mod_t partial = 0, radix = 1;
+			for (size_t j = 0; j < i; j++)
+			{
+				partial += mod_t(digits[j]) * radix;
+				radix *= mod_t(moduli[j]);
+			}
+			digits[i++] = ((residue - partial) / radix).balanced();
+		};
+		(next_digit(residues), ...);
+		int_t value = 0, radix = 1;
+		for (size_t j = 0; j < count; j++)
+		{
+			value += int_t(digits[j]) * radix;
+			if (j + 1 < count)
+				radix *= int_t(static_cast<int64_t>(moduli[j]));
+		}
+		return value;
+	}
+
+	namespace implementation_details
+	{
+		template <class int_t, class... mod_t, size_t... i>
+		int_t crt_from_residues(const std::array<uint64_t, sizeof...(mod_t)> &residues, std::index_sequence<i...>)
+		{
+			return crt_reconstruct<int_t>(mod_t(residues[i])...);
+		}
+	}
+
+	template <class target_poly_t, class... poly_t>
+	void crt_reconstruct(target_poly_t &result, const poly_t &...images)
+	{
+		typedef typename target_poly_t::scl_t scl_t;
+		std::map<typename target_poly_t::exp_t, std::array<uint64_t, sizeof...(poly_t)>> residues; //zero modulo the primes of the images missing the monomial
+		size_t i = 0;
+		const auto collect = [&](const auto &image) {
+			for (auto it = image.begin(); it != image.end(); ++it)
+				residues[it.exponent()][i] = it.coeff().residue();
+			i++;
+		};
+		(collect(images), ...);
+		for (const auto &[exponent, coeffs] : residues)
+		{
+			const scl_t coeff = implementation_details::crt_from_residues<scl_t, typename poly_t::scl_t...>(coeffs, std::index_sequence_for<poly_t...>());
+			if (coeff != 0)
+				result.insert(exponent, coeff);
+		}
+	}
+
+	template <class target_poly_t, class poly_t>
+	void convert_coefficients(target_poly_t &result, const poly_t &a)
+	{
+		typedef typename target_poly_t::scl_t scl_t;
+		for (auto it = a.begin(); it != a.end(); ++it)
+		{
+			const scl_t coeff(it.coeff());
+			if (coeff != 0)
+				result.insert(it.exponent(), coeff);
+		}
+	}
+}
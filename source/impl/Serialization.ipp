@@ -0,0 +1,246 @@
+#pragma once
+#include "../Serialization.hpp"
+
+///@file
+///@brief Implementation of Serialization.hpp
+
+namespace symmp
+{
+
+	inline MappedFile::MappedFile(const std::string &path) : bytes(nullptr), length(0)
+	{
+#if defined(SYMMP_MMAP)
+		const int descriptor = open(path.c_str(), O_RDONLY);
+		if (descriptor < 0)
+			return;
+		struct stat status;
+		if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+		{
+			void *address = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (address != MAP_FAILED)
+			{
+				bytes = static_cast<const char *>(address);
+				length = static_cast<size_t>(status.st_size);
+			}
+		}
+		close(descriptor); //the mapping stays valid
+#else
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+			return;
+		buffer.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		if (!buffer.empty() && file.read(buffer.data(), buffer.size()))
+		{
+			bytes = buffer.data();
+			length = buffer.size();
+		}
+#endif
+	}
+
+	inline MappedFile::~MappedFile()
+	{
+#if defined(SYMMP_MMAP)
+		if (bytes)
+			munmap(const_cast<char *>(bytes), length);
+#endif
+	}
+
+	inline bool MappedFile::is_open() const
+	{
+		return bytes != nullptr;
+	}
+
+	inline const char *MappedFile::data() const
+	{
+		return bytes;
+	}
+
+	inline size_t MappedFile::size() const
+	{
+		return length;
+	}
+
+	namespace implementation_details
+	{
+		constexpr char binary_magic[8] = {'S', 'Y', 'M', 'M', 'P', 'B', 'I', 'N'};
+		constexpr uint32_t binary_version = 1;
+		constexpr uint32_t byte_order_mark = 0x01020304;
+		enum class binary_kind : uint32_t
+		{
+			polynomials = 0,
+			basis = 1
+		};
+
+		///Appends the bytes of values to a buffer
+		struct BinaryWriter
+		{
+			std::string &buffer;
+
+			template <class T>
+			void put(const T &value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types are written as bytes");
+				buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+			}
+
+			void put_string(const std::string &s)
+			{
+				put(static_cast<uint32_t>(s.size()));
+				buffer.append(s);
+			}
+		};
+
+		///Reads values from a range of bytes, aborting if the range is too short
+		struct BinaryReader
+		{
+			const char *cursor;
+			const char *end;
+
+			const char *get_bytes(size_t count)
+			{
+				if (static_cast<size_t>(end - cursor) < count)
+				{
+					std::cerr << "Binary file is truncated or corrupt\n";
+					abort();
+				}
+				const char *bytes = cursor;
+				cursor += count;
+				return bytes;
+			}
+
+			template <class T>
+			T get()
+			{
+				T value;
+				std::memcpy(&value, get_bytes(sizeof(T)), sizeof(T)); //the bytes of a mapped file needn't be aligned
+				return value;
+			}
+
+			std::string get_string()
+			{
+				const auto size = get<uint32_t>();
+				return std::string(get_bytes(size), size);
+			}
+		};
+
+		///The sizes of the types of \p poly_t, which must match when reading
+		template <class poly_t>
+		std::array<uint8_t, 3> binary_type_sizes()
+		{
+			typedef std::decay_t<decltype(std::declval<const typename poly_t::exp_t &>()[0])> entry_t;
+			return {uint8_t(sizeof(typename poly_t::scl_t)), uint8_t(sizeof(entry_t)), uint8_t(sizeof(typename poly_t::deg_t))};
+		}
+
+		template <class poly_t>
+		void write_header(BinaryWriter &out, binary_kind kind)
+		{
+			out.buffer.append(binary_magic, sizeof(binary_magic));
+			out.put(binary_version);
+			out.put(byte_order_mark);
+			out.put(kind);
+			out.put(binary_type_sizes<poly_t>());
+		}
+
+		template <class poly_t>
+		bool read_header(BinaryReader &in, binary_kind kind)
+		{
+			if (static_cast<size_t>(in.end - in.cursor) < sizeof(binary_magic) || !std::equal(binary_magic, binary_magic + sizeof(binary_magic), in.get_bytes(sizeof(binary_magic))))
+				return 0;
+			return in.get<uint32_t>() == binary_version && in.get<uint32_t>() == byte_order_mark && in.get<binary_kind>() == kind && in.get<std::array<uint8_t, 3>>() == binary_type_sizes<poly_t>();
+		}
+
+		template <class poly_t>
+		void write_polynomial(BinaryWriter &out, const poly_t &a)
+		{
+			typedef typename poly_t::scl_t scl_t;
+			typedef std::decay_t<decltype(std::declval<const typename poly_t::exp_t &>()[0])> entry_t;
+			static_assert(std::is_trivially_copyable_v<scl_t>, "The coefficients are written as bytes so the scalar type must be trivially copyable");
+			std::vector<decltype(a.begin())> monomials;
+			monomials.reserve(a.number_of_monomials());
+			for (auto it = a.begin(); it != a.end(); ++it)
+				monomials.push_back(it);
+			const auto less = [](const auto &x, const auto &y) {
+				return x.degree() < y.degree() || (x.degree() == y.degree() && x.exponent() < y.exponent());
+			};
+			if (!std::is_sorted(monomials.begin(), monomials.end(), less)) //the ordered containers already are
+				std::sort(monomials.begin(), monomials.end(), less);
+			const uint32_t variables = monomials.empty() ? 0 : static_cast<uint32_t>(monomials.front().exponent().size());
+			out.put(static_cast<uint64_t>(monomials.size()));
+			out.put(variables);
+			out.buffer.reserve(out.buffer.size() + monomials.size() * (variables * sizeof(entry_t) + sizeof(scl_t)));
+			for (const auto &it : monomials)
+			{
+				const auto &exponent = it.exponent();
+				for (uint32_t i = 0; i < variables; i++)
+					out.put(static_cast<entry_t>(exponent[i]));
+				out.put(it.coeff());
+			}
+		}
+
+		template <class poly_t>
+		poly_t read_polynomial(BinaryReader &in, const typename poly_t::deg_t *dim_var, const std::string *name_var)
+		{
+			typedef typename poly_t::exp_t exp_t;
+			typedef typename poly_t::scl_t scl_t;
+			typedef std::decay_t<decltype(std::declval<const exp_t &>()[0])> entry_t;
+			const auto count = in.get<uint64_t>();
+			const auto variables = in.get<uint32_t>();
+			if (count != 0 && exp_t(variables).size() != variables)
+			{
+				std::cerr << "Binary file has polynomials on " << variables << " variables, but the exponent type has fixed size " << exp_t(variables).size() << "\n";
+				abort();
+			}
+			if (static_cast<size_t>(in.end - in.cursor) / (variables * sizeof(entry_t) + sizeof(scl_t)) < count)
+			{ //checked before allocating for a corrupt count
+				std::cerr << "Binary file is truncated or corrupt\n";
+				abort();
+			}
+			std::vector<std::pair<exp_t, scl_t>> terms;
+			terms.reserve(count);
+			for (uint64_t m = 0; m < count; m++)
+			{
+				exp_t exponent(variables);
+				for (uint32_t i = 0; i < variables; i++)
+					exponent[i] = in.get<entry_t>();
+				terms.emplace_back(std::move(exponent), in.get<scl_t>());
+			}
+			return poly_t(sorted_range, terms.begin(), terms.end(), dim_var, name_var);
+		}
+
+		inline bool write_file(const std::string &path, const std::string &buffer)
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			return file && file.write(buffer.data(), buffer.size());
+		}
+	}
+
+	template <class range_t>
+	bool save_polynomials(const std::string &path, const range_t &polynomials)
+	{
+		typedef std::decay_t<decltype(*std::begin(polynomials))> poly_t;
+		std::string buffer;
+		implementation_details::BinaryWriter out{buffer};
+		implementation_details::write_header<poly_t>(out, implementation_details::binary_kind::polynomials);
+		out.put(static_cast<uint64_t>(std::distance(std::begin(polynomials), std::end(polynomials))));
+		for (const auto &a : polynomials)
+			implementation_details::write_polynomial(out, a);
+		return implementation_details::write_file(path, buffer);
+	}
+
+	template <class poly_t>
+	std::optional<std::vector<poly_t>> load_polynomials(const std::string &path, const typename poly_t::deg_t *dim_var, const std::string *name_var)
+	{
+		const MappedFile file(path);
+		if (!file.is_open())
+			return std::nullopt;
+		implementation_details::BinaryReader in{file.data(), file.data() + file.size()};
+		if (!implementation_details::read_header<poly_t>(in, implementation_details::binary_kind::polynomials))
+			return std::nullopt;
+		const auto count = in.get<uint64_t>();
+		std::vector<poly_t> polynomials;
+		for (uint64_t i = 0; i < count; i++)
+			polynomials.push_back(implementation_details::read_polynomial<poly_t>(in, dim_var, name_var));
+		return polynomials;
+	}
+}
@@ -7,8 +7,23 @@
 namespace symmp
 {
 
-	template <typename T, typename _deg>
-	_deg StandardVariables<T, _deg>::degree() const
+	template <typename T, size_t N>
+	struct ArrayVectorWrapper : public std::array<T, N>
+	{
+		using std::array<T, N>::array;
+		static constexpr size_t static_size = N; ///<The size, known in compile-time
+		///Constructor with "size" does nothing (used to have consistent interface with vector)
+		ArrayVectorWrapper(size_t) : std::array<T, N>() {}
+	};
+
+	template <typename T>
+	struct ArrayVectorWrapper<T, 0> : public std::vector<T>
+	{
+		using std::vector<T>::vector;
+	};
+
+	template <typename T, typename _deg, size_t N>
+	_deg StandardVariables<T, _deg, N>::degree() const
 	{
 		deg_t sum = 0;
 		for (const auto i : *this)
@@ -16,14 +31,14 @@ namespace symmp
 		return sum;
 	}
 
-	template <typename T, typename _deg>
-	std::string StandardVariables<T, _deg>::name(int i, int)
+	template <typename T, typename _deg, size_t N>
+	std::string StandardVariables<T, _deg, N>::name(int i, int)
 	{
 		return "x_" + std::to_string(i + 1);
 	}
 
-	template <typename T, typename _deg>
-	StandardVariables<T, _deg> StandardVariables<T, _deg>::operator+(const StandardVariables &other) const
+	template <typename T, typename _deg, size_t N>
+	StandardVariables<T, _deg, N> StandardVariables<T, _deg, N>::operator+(const StandardVariables &other) const
 	{
 		StandardVariables v(*this);
 		for (size_t i = 0; i < this->size(); i++)
@@ -31,14 +46,22 @@ namespace symmp
 		return v;
 	}
 
-	template <typename T, typename _deg>
-	size_t StandardVariables<T, _deg>::operator()() const
+	template <typename T, typename _deg, size_t N>
+	StandardVariables<T, _deg, N> &StandardVariables<T, _deg, N>::operator+=(const StandardVariables &other)
+	{
+		for (size_t i = 0; i < this->size(); i++)
+			(*this)[i] += other[i];
+		return *this;
+	}
+
+	template <typename T, typename _deg, size_t N>
+	size_t StandardVariables<T, _deg, N>::operator()() const
 	{
 		return generic_hasher(*this);
 	}
 
-	template <typename T, typename _deg>
-	_deg ElementarySymmetricVariables<T, _deg>::degree() const
+	template <typename T, typename _deg, size_t N>
+	_deg ElementarySymmetricVariables<T, _deg, N>::degree() const
 	{
 		deg_t deg = 0;
 		for (size_t i = 0; i < this->size(); i++)
@@ -46,8 +69,8 @@ namespace symmp
 		return deg;
 	}
 
-	template <typename T, typename _deg>
-	std::string ElementarySymmetricVariables<T, _deg>::name(int i, int)
+	template <typename T, typename _deg, size_t N>
+	std::string ElementarySymmetricVariables<T, _deg, N>::name(int i, int)
 	{
 		return "e_" + std::to_string(i + 1);
 	}
@@ -55,34 +78,273 @@ namespace symmp
 	template <typename T, typename orig_poly_t, typename new_poly_t>
 	new_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::operator()(orig_poly_t a) const
 	{
+		MonotonicArena arena;
+		return decompose(std::move(a), caches, arena);
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	orig_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::operator()(const new_poly_t &a) const
+	{
+		MonotonicArena arena;
+		return expand(a, caches, arena);
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	template <class range_t>
+	std::vector<new_poly_t> PolynomialBasis<T, orig_poly_t, new_poly_t>::decompose_batch(const range_t &polynomials, int threads, std::vector<double> *seconds) const
+	{
+		return run_batch<new_poly_t>(polynomials, threads, seconds, nullptr, [this](const orig_poly_t &a, Caches &local, MonotonicArena &arena) { return decompose(a, local, arena); });
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	template <class range_t, class fun>
+	void PolynomialBasis<T, orig_poly_t, new_poly_t>::decompose_stream(const range_t &polynomials, const fun &consume, int threads) const
+	{
+		run_batch<new_poly_t>(polynomials, threads, nullptr, consume, [this](const orig_poly_t &a, Caches &local, MonotonicArena &arena) { return decompose(a, local, arena); });
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	template <class range_t>
+	std::vector<orig_poly_t> PolynomialBasis<T, orig_poly_t, new_poly_t>::expand_batch(const range_t &polynomials, int threads, std::vector<double> *seconds) const
+	{
+		return run_batch<orig_poly_t>(polynomials, threads, seconds, nullptr, [this](const new_poly_t &a, Caches &local, MonotonicArena &arena) { return expand(a, local, arena); });
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	template <class range_t, class fun>
+	void PolynomialBasis<T, orig_poly_t, new_poly_t>::expand_stream(const range_t &polynomials, const fun &consume, int threads) const
+	{
+		run_batch<orig_poly_t>(polynomials, threads, nullptr, consume, [this](const new_poly_t &a, Caches &local, MonotonicArena &arena) { return expand(a, local, arena); });
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	template <class poly_t, class range_t, class sink, class fun>
+	auto PolynomialBasis<T, orig_poly_t, new_poly_t>::run_batch(const range_t &polynomials, int threads, std::vector<double> *seconds, const sink &consume, const fun &transform) const
+	{
+		constexpr bool streamed = !std::is_same_v<sink, std::nullptr_t>;
+		//the elements of a range that constructs them on the fly (eg TwistedChernBasis::relations()) are constructed by the workers,
+		//so they are never all stored at once; only the positions of the range are kept
+		constexpr bool stored = std::is_lvalue_reference_v<decltype(*std::begin(polynomials))>;
+		std::vector<const std::decay_t<decltype(*std::begin(polynomials))> *> inputs;
+		std::vector<decltype(std::begin(polynomials))> positions;
+		if constexpr (stored)
+			for (const auto &a : polynomials)
+				inputs.push_back(&a);
+		else
+			for (auto it = std::begin(polynomials); it != std::end(polynomials); ++it)
+				positions.push_back(it);
+		const size_t count = stored ? inputs.size() : positions.size();
+		std::vector<size_t> order(count);
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		if constexpr (stored && !streamed)
+		{ //start from the most expensive (a stream starts in order, so that each result can be passed on and freed soon after it's ready)
+			std::vector<double> cost(count, 0);
+			for (size_t i = 0; i < count; i++)
+				if (inputs[i]->number_of_monomials() != 0)
+					cost[i] = (static_cast<double>(inputs[i]->highest_term().degree()) + 1) * inputs[i]->number_of_monomials();
+			std::stable_sort(order.begin(), order.end(), [&](size_t i, size_t j) { return cost[i] > cost[j]; });
+		}
+		TaskPool pool(threads);
+		std::vector<Caches> local(pool.threads(), caches); //copies the settings only
+		std::vector<MonotonicArena> arenas(pool.threads());
+		std::vector<std::optional<poly_t>> results(count); //constructed by the workers, with the allocator of their own thread
+		if (seconds)
+			seconds->assign(count, 0);
+		std::mutex stream_mutex; //guards ready and next, and serializes the calls of consume
+		std::vector<char> ready(streamed ? count : 0, 0);
+		size_t next = 0;
+		pool.run(order, [&](size_t i, int worker) {
+			const auto start = std::chrono::steady_clock::now();
+			if constexpr (stored)
+				results[i].emplace(transform(*inputs[i], local[worker], arenas[worker]));
+			else
+				results[i].emplace(transform(*positions[i], local[worker], arenas[worker]));
+			arenas[worker].reset();
+			if (seconds)
+				(*seconds)[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if constexpr (streamed)
+			{ //the worker that completes the longest finished prefix passes it on, in order
+				std::lock_guard<std::mutex> guard(stream_mutex);
+				ready[i] = 1;
+				for (; next < count && ready[next]; next++)
+				{
+					consume(next, std::move(*results[next]));
+					results[next].reset();
+				}
+			}
+		});
+		if constexpr (!streamed)
+		{
+			std::vector<poly_t> ordered;
+			ordered.reserve(results.size());
+			for (auto &result : results)
+				ordered.push_back(std::move(*result));
+			return ordered;
+		}
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	new_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::decompose(orig_poly_t a, Caches &caches, MonotonicArena &arena) const
+	{
+		constexpr bool graded = implementation_details::is_graded_container<orig_poly_t>::value;
 		//set dimensions and names if nonempty
 		const typename new_poly_t::deg_t *gen_dims = generator_dimensions.empty() ? nullptr : generator_dimensions.data();
 		const std::string *gen_names = generator_names.empty() ? nullptr : generator_names.data();
 		new_poly_t decomposition(gen_dims, gen_names);
-		while (true)
+		//the generators are homogeneous so each step only changes the component of the highest degree:
+		//a is either split into all its components now (moving them if graded, copying them otherwise),
+		//or if that would exceed the memory limit, its top component is moved out whenever the previous one is exhausted
+		const bool track = memory_limit != 0 || memory_tracking; //the footprint is only estimated if it's needed, as it visits every component after each step
+		const size_t input = track ? a.memory_usage().total() : 0;
+		const bool stream = memory_limit != 0 && (graded ? input : 2 * input) > memory_limit;
+		std::map<typename orig_poly_t::deg_t, orig_poly_t> components;
+		if (!stream)
+		{
+			components = std::move(a).homogeneous_components();
+			auto released = std::move(a); //the ungraded components are copies
+		}
+		size_t peak = (graded || stream) ? input : 2 * input;
+		const auto held = [&]() {
+			MemoryUsage usage = a.memory_usage();
+			usage += decomposition.memory_usage();
+			for (const auto &component : components)
+				usage += component.second.memory_usage();
+			return usage.total();
+		};
+		SYMMP_INSTRUMENT_COUNT(decompositions, 1);
+#if defined(SYMMP_INSTRUMENT)
+		const auto monomials = [&components, &a]() {
+			size_t total = a.number_of_monomials();
+			for (const auto &component : components)
+				total += component.second.number_of_monomials();
+			return total;
+		};
+		size_t peak_monomials = monomials();
+#endif
+		ArenaScope scope(&arena); //the results are constructed before the arena is in scope so they don't use it
+		while (!components.empty() || a.number_of_monomials() != 0)
 		{
-			auto max = a.highest_term();
-			auto exponent = static_cast<const T *>(this)->find_exponent(max.exponent());
-			auto product = compute_product(exponent);
-			auto coeff = max.coeff() / product.highest_term().coeff();
+			if (components.empty())
+			{ //the remainder of a must not use the arena
+				ArenaScope heap(std::pmr::new_delete_resource());
+				const auto degree = a.highest_term().degree();
+				components.emplace(degree, a.extract_homogeneous_component(degree));
+			}
+			auto top = std::prev(components.end());
+			if (top->second.number_of_monomials() == 0)
+			{
+				components.erase(top);
+				continue;
+			}
+			{
+				SYMMP_INSTRUMENT_COUNT(reduction_iterations, 1);
+				auto max = SYMMP_INSTRUMENTED(highest_term, top->second.highest_term());
+				auto exponent = SYMMP_INSTRUMENTED(find_exponent, static_cast<const T *>(this)->find_exponent(max.exponent()));
+				auto product = SYMMP_INSTRUMENTED(compute_product, compute_product(exponent, caches));
+				auto coeff = max.coeff() / product.highest_term().coeff();
+				decomposition.insert(exponent, coeff);
+				SYMMP_INSTRUMENT_COUNT(product_terms, product.number_of_monomials());
+				SYMMP_INSTRUMENT_PHASE(subtract);
+				product *= coeff;
+				if (product.is_homogeneous(top->first))
+					top->second -= product;
+				else
+				{ //distribute the product among the components (or when streaming, the rest of a), which must not use the arena
+					ArenaScope heap(std::pmr::new_delete_resource());
+					for (auto &[degree, part] : std::move(product).homogeneous_components())
+					{
+						if (stream && degree != top->first)
+						{
+							a -= part;
+							continue;
+						}
+						part *= -1;
+						auto [component, inserted] = components.try_emplace(degree, part);
+						if (!inserted)
+							component->second += part;
+					}
+				}
+				if (track)
+					peak = std::max(peak, held() + product.memory_usage().total());
+			}
+#if defined(SYMMP_INSTRUMENT)
+			peak_monomials = std::max(peak_monomials, monomials());
+#endif
+			arena.reset();
+		}
+#if defined(SYMMP_INSTRUMENT)
+		implementation_details::instrument_peak(peak_monomials);
+#endif
+		size_t previous = peak_bytes.load(std::memory_order_relaxed);
+		while (previous < peak && !peak_bytes.compare_exchange_weak(previous, peak, std::memory_order_relaxed))
+			;
+		decompositions.fetch_add(1, std::memory_order_relaxed);
+		if (stream)
+			streamed.fetch_add(1, std::memory_order_relaxed);
+		return decomposition;
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	template <size_t blocks>
+	new_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::operator()(const OrbitPolynomial<orig_poly_t, blocks> &a) const
+	{
+		typedef OrbitPolynomial<orig_poly_t, blocks> orbit_t;
+		const typename new_poly_t::deg_t *gen_dims = generator_dimensions.empty() ? nullptr : generator_dimensions.data();
+		const std::string *gen_names = generator_names.empty() ? nullptr : generator_names.data();
+		new_poly_t decomposition(gen_dims, gen_names);
+		SYMMP_INSTRUMENT_COUNT(decompositions, 1);
+		//(generator index, power) -> the compressed power of the generator
+		std::map<std::pair<size_t, size_t>, orbit_t> powers;
+		const auto power = [&](size_t i, size_t p) -> const orbit_t & {
+			auto base = powers.try_emplace({i, 1}, generator(i)).first;
+			for (size_t q = 2; q <= p; q++)
+				if (powers.find({i, q}) == powers.end())
+					powers.emplace(std::make_pair(i, q), powers.at({i, q - 1}) * base->second);
+			return powers.at({i, p});
+		};
+		orbit_t remainder = a;
+		while (remainder.number_of_monomials() != 0)
+		{
+			SYMMP_INSTRUMENT_COUNT(reduction_iterations, 1);
+			const auto max = SYMMP_INSTRUMENTED(highest_term, remainder.highest_term());
+			const auto exponent = SYMMP_INSTRUMENTED(find_exponent, static_cast<const T *>(this)->find_exponent(max.first));
+			orbit_t product(orig_poly_t(number_of_variables, 1)); //stays 1 if the exponent is 0
+			{
+				SYMMP_INSTRUMENT_PHASE(compute_product);
+				bool first = 1;
+				for (size_t i = 0; i < exponent.size(); i++)
+					if (exponent[i] != 0)
+					{
+						product = first ? power(i, exponent[i]) : product * power(i, exponent[i]);
+						first = 0;
+					}
+			}
+			const auto coeff = max.second / product.highest_term().second;
 			decomposition.insert(exponent, coeff);
+			SYMMP_INSTRUMENT_COUNT(product_terms, product.number_of_monomials());
+			SYMMP_INSTRUMENT_PHASE(subtract);
 			product *= coeff;
-			if (a == product)
-				return decomposition;
-			else
-				a -= product;
+			remainder -= product;
 		}
+		return decomposition;
 	}
 
 	template <typename T, typename orig_poly_t, typename new_poly_t>
-	orig_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::operator()(const new_poly_t&a) const
+	orig_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::expand(const new_poly_t &a, Caches &caches, MonotonicArena &arena) const
 	{
 		orig_poly_t p;
+		SYMMP_INSTRUMENT_COUNT(expansions, 1);
+		ArenaScope scope(&arena);
 		for (auto it = a.begin(); it != a.end(); ++it)
 		{
-			auto prod = compute_product(it.exponent());
-			prod *= it.coeff();
-			p += prod;
+			{
+				auto prod = SYMMP_INSTRUMENTED(compute_product, compute_product(it.exponent(), caches));
+				SYMMP_INSTRUMENT_PHASE(add);
+				prod *= it.coeff();
+				p += prod;
+			}
+			arena.reset();
 		}
 		return p;
 	}
@@ -93,9 +355,109 @@ namespace symmp
 	template <typename T, typename orig_poly_t, typename new_poly_t>
 	const std::vector<orig_poly_t> & PolynomialBasis<T, orig_poly_t, new_poly_t>::generators() const
 	{
+		for (size_t i = 0; i < _generators.size(); i++)
+			generator(i);
 		return _generators;
 	}
 
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	const orig_poly_t &PolynomialBasis<T, orig_poly_t, new_poly_t>::generator(size_t i) const
+	{
+		std::call_once(generator_flags[i], [&]() {
+			ArenaScope heap(std::pmr::new_delete_resource()); //may be called during an expansion, whose arena is reset
+			if (generator_file)
+			{
+				implementation_details::BinaryReader in{generator_file->data() + generator_offsets[i], generator_file->data() + generator_file->size()};
+				_generators[i] = implementation_details::read_polynomial<orig_poly_t>(in, nullptr, nullptr);
+			}
+			else
+				_generators[i] = static_cast<const T *>(this)->make_generator(i);
+		});
+		return _generators[i];
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	size_t PolynomialBasis<T, orig_poly_t, new_poly_t>::number_of_generators() const
+	{
+		return _generators.size();
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	void PolynomialBasis<T, orig_poly_t, new_poly_t>::set_number_of_generators(size_t count, bool lazy)
+	{
+		_generators = std::vector<orig_poly_t>(count);
+		generator_flags = std::vector<std::once_flag>(count);
+		if (!lazy)
+			generators();
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	bool PolynomialBasis<T, orig_poly_t, new_poly_t>::save(const std::string &path) const
+	{
+		using namespace implementation_details;
+		generators();
+		std::string buffer;
+		BinaryWriter out{buffer};
+		write_header<orig_poly_t>(out, binary_kind::basis);
+		out.put(static_cast<uint8_t>(sizeof(typename new_poly_t::deg_t)));
+		out.put(static_cast<uint32_t>(number_of_variables));
+		out.put(static_cast<uint64_t>(_generators.size()));
+		out.put(static_cast<uint64_t>(generator_dimensions.size()));
+		for (const auto &d : generator_dimensions)
+			out.put(d);
+		out.put(static_cast<uint64_t>(generator_names.size()));
+		for (const auto &name : generator_names)
+			out.put_string(name);
+		const size_t offsets = buffer.size(); //the offset table is filled in as the generators are written
+		buffer.resize(offsets + _generators.size() * sizeof(uint64_t));
+		for (size_t i = 0; i < _generators.size(); i++)
+		{
+			const auto offset = static_cast<uint64_t>(buffer.size());
+			std::memcpy(&buffer[offsets + i * sizeof(uint64_t)], &offset, sizeof(uint64_t));
+			write_polynomial(out, _generators[i]);
+		}
+		return write_file(path, buffer);
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	bool PolynomialBasis<T, orig_poly_t, new_poly_t>::load(const std::string &path)
+	{
+		using namespace implementation_details;
+		auto file = std::make_shared<const MappedFile>(path);
+		if (!file->is_open())
+			return 0;
+		BinaryReader in{file->data(), file->data() + file->size()};
+		if (!read_header<orig_poly_t>(in, binary_kind::basis) || in.get<uint8_t>() != sizeof(typename new_poly_t::deg_t))
+			return 0;
+		if (in.get<uint32_t>() != static_cast<uint32_t>(number_of_variables) || in.get<uint64_t>() != _generators.size())
+			return 0;
+		if (in.get<uint64_t>() != generator_dimensions.size())
+			return 0;
+		for (const auto &d : generator_dimensions)
+			if (in.get<typename new_poly_t::deg_t>() != d)
+				return 0;
+		if (in.get<uint64_t>() != generator_names.size())
+			return 0;
+		for (const auto &name : generator_names)
+			if (in.get_string() != name)
+				return 0;
+		std::vector<uint64_t> offsets(_generators.size());
+		for (auto &offset : offsets)
+		{
+			offset = in.get<uint64_t>();
+			if (offset >= file->size())
+			{
+				std::cerr << "Binary file is truncated or corrupt";
+				abort();
+			}
+		}
+		generator_file = std::move(file);
+		generator_offsets = std::move(offsets);
+		_generators = std::vector<orig_poly_t>(generator_offsets.size());
+		generator_flags = std::vector<std::once_flag>(generator_offsets.size());
+		return 1;
+	}
+
 	template <typename T, typename orig_poly_t, typename new_poly_t>
 	const std::vector<typename new_poly_t::deg_t> & PolynomialBasis<T, orig_poly_t, new_poly_t>::dimensions() const
 	{
@@ -109,52 +471,175 @@ namespace symmp
 	}
 
 	template <typename T, typename orig_poly_t, typename new_poly_t>
-	orig_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::compute_product(const typename new_poly_t::exp_t &exponent) const
+	void PolynomialBasis<T, orig_poly_t, new_poly_t>::configure_cache(size_t capacity, bool thread_safe)
+	{
+		caches.powers.configure(capacity, thread_safe);
+		caches.products.configure(capacity, thread_safe);
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	CacheStatistics PolynomialBasis<T, orig_poly_t, new_poly_t>::power_cache_statistics() const
+	{
+		return caches.powers.statistics();
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	CacheStatistics PolynomialBasis<T, orig_poly_t, new_poly_t>::product_cache_statistics() const
+	{
+		return caches.products.statistics();
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	void PolynomialBasis<T, orig_poly_t, new_poly_t>::set_memory_limit(size_t bytes)
+	{
+		memory_limit = bytes;
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	void PolynomialBasis<T, orig_poly_t, new_poly_t>::track_memory(bool enabled)
+	{
+		memory_tracking = enabled;
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	MemoryStatistics PolynomialBasis<T, orig_poly_t, new_poly_t>::memory_statistics() const
 	{
-		orig_poly_t product(number_of_variables, 1);
+		MemoryStatistics statistics;
+		statistics.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+		statistics.decompositions = decompositions.load(std::memory_order_relaxed);
+		statistics.streamed = streamed.load(std::memory_order_relaxed);
+		return statistics;
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	void PolynomialBasis<T, orig_poly_t, new_poly_t>::reset_memory_statistics()
+	{
+		peak_bytes.store(0, std::memory_order_relaxed);
+		decompositions.store(0, std::memory_order_relaxed);
+		streamed.store(0, std::memory_order_relaxed);
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	std::shared_ptr<const orig_poly_t> PolynomialBasis<T, orig_poly_t, new_poly_t>::power(size_t i, size_t p, Caches &caches) const
+	{
+		if (p == 1) //non owning pointer
+			return std::shared_ptr<const orig_poly_t>(std::shared_ptr<void>(), &generator(i));
+		const size_t key = i + p * _generators.size();
+		if (auto cached = caches.powers.find(key))
+			return cached;
+		auto computed = std::make_shared<const orig_poly_t>(generator(i) ^ p);
+		caches.powers.insert(key, *computed);
+		return computed;
+	}
+
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	orig_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::compute_product(const new_exp_t &exponent, Caches &caches) const
+	{
+		std::vector<size_t> factors; //the generators appearing in the product
 		for (size_t i = 0; i < _generators.size(); i++)
 			if (exponent[i] != 0)
-				product *= (_generators[i] ^ exponent[i]);
+				factors.push_back(i);
+		if (factors.empty())
+			return orig_poly_t(number_of_variables, 1);
+		//find the longest cached prefix g_{i_1}^{p_1}...g_{i_k}^{p_k} of the product
+		auto prefix = exponent;
+		size_t start = factors.size();
+		std::shared_ptr<const orig_poly_t> cached;
+		for (; start > 1; start--)
+		{
+			if ((cached = caches.products.find(prefix, 0)))
+				break;
+			prefix[factors[start - 1]] = 0;
+		}
+		if (factors.size() > 1)
+			caches.products.count(cached != nullptr);
+		if (!cached)
+			cached = power(factors[0], exponent[factors[0]], caches);
+		orig_poly_t product(*cached);
+		for (size_t j = start; j < factors.size(); j++)
+		{
+			const auto i = factors[j];
+			product *= *power(i, exponent[i], caches);
+			prefix[i] = exponent[i];
+			caches.products.insert(prefix, product);
+		}
 		return product;
 	}
 
-	template <typename x_poly_t, typename e_poly_t>
-	SymmetricBasis<x_poly_t, e_poly_t>::SymmetricBasis(int n) : PolynomialBasis<SymmetricBasis<x_poly_t, e_poly_t>, x_poly_t, e_poly_t>(n)
+	template <typename T, typename orig_poly_t, typename new_poly_t>
+	template <class fun>
+	orig_poly_t PolynomialBasis<T, orig_poly_t, new_poly_t>::build_in_parallel(size_t size, size_t terms_per_item, const fun &build)
 	{
-		_generators.reserve(number_of_variables);
-		for (int i = 1; i <= number_of_variables; i++)
-			_generators.push_back(get_elementary_symmetric(i));
+		constexpr size_t terms_per_slice = 1 << 12; //smaller slices are not worth a task
+		const size_t slice = std::max<size_t>(1, terms_per_slice / std::max<size_t>(1, terms_per_item));
+		TaskPool pool;
+		terms_t terms;
+		if (size <= slice || pool.threads() == 1)
+			terms = build(0, size);
+		else
+		{
+			std::vector<size_t> slices((size + slice - 1) / slice);
+			for (size_t k = 0; k < slices.size(); k++)
+				slices[k] = k;
+			std::vector<terms_t> parts(slices.size());
+			pool.run(slices, [&](size_t k, int) { parts[k] = build(k * slice, std::min(size, (k + 1) * slice)); });
+			size_t total = 0;
+			for (const auto &part : parts)
+				total += part.size();
+			terms.reserve(total);
+			for (auto &part : parts)
+				std::move(part.begin(), part.end(), std::back_inserter(terms));
+		}
+		return orig_poly_t(sorted_range, terms.rbegin(), terms.rend());
 	}
 
 	template <typename x_poly_t, typename e_poly_t>
-	x_poly_t SymmetricBasis<x_poly_t, e_poly_t>::get_elementary_symmetric(int i) const
+	SymmetricBasis<x_poly_t, e_poly_t>::SymmetricBasis(int n, bool lazy) : PolynomialBasis<SymmetricBasis<x_poly_t, e_poly_t>, x_poly_t, e_poly_t>(n)
 	{
-		x_poly_t poly;
-		x_t mono(number_of_variables);
-		auto c = CombinationGenerator(number_of_variables, i);
-		for (const auto &comb : c)
+		constexpr size_t x_size = implementation_details::static_size<x_t>::value, e_size = implementation_details::static_size<e_t>::value;
+		if ((x_size != 0 && x_size != size_t(n)) || (e_size != 0 && e_size != size_t(n)))
 		{
-			for (const auto j : comb)
-				mono[j] = 1;
-			poly.insert(mono, 1);
-			for (const auto j : comb)
-				mono[j] = 0;
+			std::cerr << "The number of variables must match the compile-time size of the exponents";
+			abort();
 		}
-		return poly;
+		this->set_number_of_generators(number_of_variables, lazy);
+	}
+
+	template <typename x_poly_t, typename e_poly_t>
+	x_poly_t SymmetricBasis<x_poly_t, e_poly_t>::make_generator(size_t i) const
+	{
+		return get_elementary_symmetric(i + 1);
+	}
+
+	template <typename x_poly_t, typename e_poly_t>
+	x_poly_t SymmetricBasis<x_poly_t, e_poly_t>::get_elementary_symmetric(int i) const
+	{
+		const auto c = CombinationGenerator(number_of_variables, i);
+		return this->build_in_parallel(c.size(), 1, [&](size_t first, size_t last) {
+			typename SymmetricBasis::terms_t terms;
+			terms.reserve(last - first);
+			x_t mono(number_of_variables);
+			for (const auto &comb : c.slice(first, last))
+			{
+				for (const auto j : comb)
+					mono[j] = 1;
+				terms.emplace_back(mono, 1);
+				for (const auto j : comb)
+					mono[j] = 0;
+			}
+			return terms;
+		});
 	}
 
 	template <typename x_poly_t, typename e_poly_t>
 	auto SymmetricBasis<x_poly_t, e_poly_t>::find_exponent(const x_t &term) const -> e_t
 	{
-		e_t exponent;
-		exponent.reserve(number_of_variables);
-		for (size_t i = 0; i < term.size(); i++)
-		{
-			if (i+1 == term.size())
-				exponent.push_back(term[i]);
-			else
-				exponent.push_back(term[i] - term[i + 1]);
-		}
+		e_t exponent(number_of_variables);
+		const size_t size = term.size(); //a compile-time constant for fixed-size exponents
+		for (size_t i = 0; i + 1 < size; i++)
+			exponent[i] = term[i] - term[i + 1];
+		if (size > 0)
+			exponent[size - 1] = term[size - 1];
 		return exponent;
 	}
 }
\ No newline at end of file
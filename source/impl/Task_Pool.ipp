@@ -0,0 +1,63 @@
+#pragma once
+#include "../Task_Pool.hpp"
+
+///	@file
+///	@brief Implementation of Task_Pool.hpp
+
+namespace symmp
+{
+
+	inline TaskPool::TaskPool(int threads)
+	{
+#ifdef SYMMP_OPEN_MP_ENABLED
+		workers = (threads > 0) ? threads : omp_get_max_threads();
+#else
+		(void)threads;
+		workers = 1;
+#endif
+	}
+
+	inline int TaskPool::threads() const
+	{
+		return workers;
+	}
+
+	template <class fun>
+	void TaskPool::run(const std::vector<size_t> &tasks, const fun &run) const
+	{
+		std::vector<Queue> queues(workers);
+		for (size_t k = 0; k < tasks.size(); k++)
+			queues[k % workers].tasks.push_back(tasks[k]);
+		//no task is ever added, so a worker that finds every queue empty is done
+		auto work = [&](int worker) {
+			while (true)
+			{
+				size_t task;
+				bool found = 0;
+				for (int v = 0; v < workers && !found; v++)
+				{
+					auto &queue = queues[(worker + v) % workers]; //first its own queue, then steal
+					std::lock_guard<std::mutex> guard(queue.mutex);
+					if (!queue.tasks.empty())
+					{
+						task = queue.tasks.front();
+						queue.tasks.pop_front();
+						found = 1;
+					}
+				}
+				if (!found)
+					return;
+				run(task, worker);
+			}
+		};
+#ifdef SYMMP_OPEN_MP_ENABLED
+		if (workers > 1 && !omp_in_parallel())
+		{
+#pragma omp parallel num_threads(workers)
+			work(omp_get_thread_num());
+			return;
+		}
+#endif
+		work(0);
+	}
+}